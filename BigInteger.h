@@ -0,0 +1,4618 @@
+#ifndef BIGINTEGER_H
+#define BIGINTEGER_H
+
+#include <iostream>
+#include <cstring>   // Для strlen, memcpy, memset
+#include <climits>   // Для INT_MAX, INT_MIN
+#include <cmath>     // Для log2, exp2 (начальная оценка корня)
+#include <cstdlib>   // Для abs, getenv
+#include <utility>   // Для std::move
+#include <type_traits> // Для enable_if (операторы со встроенными целыми)
+#include <string>
+#include <sstream>
+#include <new>       // Для operator new/delete рабочей памяти
+#include <vector>
+#include <deque>
+#include <algorithm> // Для lower_bound (таблица малых простых)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>     // Для open, mmap: ColumnFile отображает файл в память
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Количество блоков, хранящихся прямо внутри объекта.
+// Числа большего размера размещаются в куче, буфер растет по мере необходимости,
+// поэтому верхнего ограничения на размер числа нет.
+static const size_t INLINE_BIGINT_DIGITS = 4;
+
+// Значение, хранимое прямо в объекте без блоков (small_value): 64 бита со знаком по умолчанию,
+// -DBIGINT_SMALL_BITS=128 - 128 бит (__int128). Переполнение проверяется встроенными функциями
+// __builtin_*_overflow; в формат блоков переходят только не поместившиеся результаты.
+// Модуль такого значения занимает не больше INLINE_BIGINT_DIGITS 32-битных блоков
+#ifndef BIGINT_SMALL_BITS
+#define BIGINT_SMALL_BITS 64
+#endif
+
+#if BIGINT_SMALL_BITS == 128
+typedef __int128 small_int_t;
+typedef unsigned __int128 small_uint_t;
+#elif BIGINT_SMALL_BITS == 64
+typedef long long small_int_t;
+typedef unsigned long long small_uint_t;
+#else
+#error "BIGINT_SMALL_BITS: 64 или 128"
+#endif
+
+// numeric_limits для __int128 определен не во всех режимах (-std=c++17 без расширений GNU)
+static const small_int_t SMALL_INT_MAX = (small_int_t)(~(small_uint_t)0 >> 1);
+static const small_int_t SMALL_INT_MIN = -SMALL_INT_MAX - 1;
+
+// Простые числа вида c * 2^k + 1 для NTT (первообразный корень 3 у всех трех).
+// NTT работает с 32-битными частями блоков. Результаты по трем модулям объединяются по китайской
+// теореме об остатках: произведение модулей (~2^86) больше любого коэффициента свертки,
+// пока меньший сомножитель не длиннее 2^22 32-битных частей.
+static const unsigned int NTT_PRIME_1 = 998244353u;
+static const unsigned int NTT_PRIME_2 = 167772161u;
+static const unsigned int NTT_PRIME_3 = 469762049u;
+static const unsigned int NTT_PRIMITIVE_ROOT = 3;
+static const size_t NTT_MAX_LENGTH = (size_t)1 << 23; // Наибольшая длина преобразования (в 32-битных частях)
+static const size_t NTT_PARALLEL_CHUNK = (size_t)1 << 14; // Бабочек этапа NTT в одном куске для потоков пула
+
+// Перевод между системами счисления: числа до RADIX_BASECASE блоков переводятся квадратичным
+// алгоритмом, большие - "разделяй и властвуй" через кэшированные степени основания
+static const size_t RADIX_BASECASE = 48;
+// Обратная величина делителя до RECIPROCAL_BASECASE_BITS бит вычисляется делением, длиннее - методом Ньютона
+static const size_t RECIPROCAL_BASECASE_BITS = 2048;
+// Наибольший уровень кэша степеней: base^(k * 2^level) (заведомо больше любого реального числа)
+static const size_t RADIX_MAX_LEVELS = 40;
+// Степени и обратные величины длиннее RADIX_CACHE_KEEP_LIMBS блоков хранятся в кэше потока только
+// на время одного перевода, меньшие - до BigInteger::clear_caches() или завершения потока
+static const size_t RADIX_CACHE_KEEP_LIMBS = (size_t)1 << 16;
+
+// Пакетные операции: оценка работы в операциях над блоками, начиная с которой пакет делится
+// между потоками пула, и наименьшая работа одного куска (меньшие куски не окупают раздачу)
+static const size_t BATCH_PARALLEL_WORK = (size_t)1 << 17;
+static const size_t BATCH_CHUNK_WORK = (size_t)1 << 14;
+
+// Простые числа: перед вероятностными тестами число проверяется делением на простые меньше
+// PRIME_TRIAL_LIMIT, решето next_prime использует простые меньше PRIME_SIEVE_LIMIT.
+// Кандидаты next_prime начиная с PRIME_PARALLEL_BITS бит проверяются в потоках пула
+static const unsigned int PRIME_TRIAL_LIMIT = 1024;
+static const unsigned int PRIME_SIEVE_LIMIT = 1 << 16;
+static const size_t PRIME_PARALLEL_BITS = 256;
+
+// --- Рабочая память ядер ---
+
+// Арена рабочей памяти потока: непрерывный буфер, из которого временные массивы ядер
+// выделяются сдвигом вершины и возвращаются в обратном порядке (LIFO), без обращений к куче
+// и без обнуления. Запрос, не поместившийся в арену, обслуживается кучей; когда арена
+// опустевает, она вырастает до наибольшего замеченного одновременного объема (но не больше limit).
+// У каждого потока своя арена по умолчанию; install подключает к текущему потоку свою.
+// Кроме арены, поток держит кэш степеней для перевода чисел в строки и обратно
+// (BigInteger::clear_caches освобождает его; по размеру он ограничен RADIX_CACHE_KEEP_LIMBS).
+// С BIGINT_NO_SCRATCH_ARENA все запросы идут в кучу (для проверки выхода за границы санитайзерами)
+class ScratchArena {
+public:
+    // Статистика для подбора размера арены
+    struct Stats {
+        size_t capacity;          // Текущий размер арены, байт
+        size_t high_water;        // Наибольший одновременно занятый объем (включая запросы к куче), байт
+        size_t arena_allocations; // Запросы, обслуженные ареной (выделения в куче, которых удалось избежать)
+        size_t heap_allocations;  // Запросы, обслуженные кучей
+    };
+
+    static const size_t DEFAULT_LIMIT = (size_t)16 << 20;
+
+    explicit ScratchArena(size_t capacity = 0, size_t limit = DEFAULT_LIMIT)
+        : buffer_(0), capacity_(0), top_(0), live_(0), demand_(0), limit_(limit) {
+        stats_.capacity = stats_.high_water = stats_.arena_allocations = stats_.heap_allocations = 0;
+        reserve(capacity);
+    }
+
+    ~ScratchArena() { ::operator delete(buffer_); }
+
+    // Арена текущего потока (подключенная через install или арена по умолчанию)
+    static ScratchArena& local() {
+        ScratchArena* installed = current();
+        return installed ? *installed : default_arena();
+    }
+
+    // Подключение арены к текущему потоку (0 - вернуть арену по умолчанию).
+    // Арена должна жить, пока подключена, и не должна переключаться во время вычислений
+    static void install(ScratchArena* arena) { current() = arena; }
+
+    // Заранее выделить не меньше bytes байт (действует, только пока арена пуста)
+    void reserve(size_t bytes) {
+        if (live_ != 0 || bytes <= capacity_) return;
+        ::operator delete(buffer_);
+        buffer_ = static_cast<unsigned char*>(::operator new(bytes));
+        capacity_ = bytes;
+        stats_.capacity = capacity_;
+    }
+
+    // Наибольший размер, до которого арена растет сама
+    void set_limit(size_t bytes) { limit_ = bytes; }
+
+    Stats stats() const { return stats_; }
+
+    void reset_stats() {
+        stats_.high_water = demand_;
+        stats_.arena_allocations = stats_.heap_allocations = 0;
+    }
+
+    void* allocate(size_t bytes) {
+        bytes = round_up(bytes);
+        ++live_;
+        demand_ += bytes;
+        if (demand_ > stats_.high_water) stats_.high_water = demand_;
+#ifndef BIGINT_NO_SCRATCH_ARENA
+        if (bytes <= capacity_ - top_) {
+            void* result = buffer_ + top_;
+            top_ += bytes;
+            ++stats_.arena_allocations;
+            return result;
+        }
+#endif
+        ++stats_.heap_allocations;
+        return ::operator new(bytes);
+    }
+
+    void release(void* p, size_t bytes) {
+        bytes = round_up(bytes);
+        unsigned char* block = static_cast<unsigned char*>(p);
+        if (block >= buffer_ && block < buffer_ + capacity_) {
+            if (block + bytes == buffer_ + top_) top_ -= bytes;
+        } else {
+            ::operator delete(p);
+        }
+        demand_ -= bytes;
+        if (--live_ == 0) {
+            top_ = 0; // Освобождение не по порядку сбрасывается, когда арена опустела
+#ifndef BIGINT_NO_SCRATCH_ARENA
+            size_t wanted = stats_.high_water < limit_ ? stats_.high_water : limit_;
+            if (wanted > capacity_) reserve(wanted);
+#endif
+        }
+    }
+
+private:
+    unsigned char* buffer_;
+    size_t capacity_;
+    size_t top_;    // Занято от начала буфера, байт
+    size_t live_;   // Невозвращенные запросы (в арене и в куче)
+    size_t demand_; // Суммарный размер невозвращенных запросов, байт
+    size_t limit_;
+    Stats stats_;
+
+    ScratchArena(const ScratchArena&);
+    ScratchArena& operator=(const ScratchArena&);
+
+    // Выравнивание по 16 байт: подходит для любых блоков и двойных блоков
+    static size_t round_up(size_t bytes) { return ((bytes ? bytes : 1) + 15) & ~(size_t)15; }
+
+    static ScratchArena*& current() {
+        static thread_local ScratchArena* installed = 0;
+        return installed;
+    }
+
+    static ScratchArena& default_arena() {
+        static thread_local ScratchArena arena;
+        return arena;
+    }
+};
+
+// Временный буфер для вспомогательных вычислений из арены текущего потока
+// (возвращается автоматически; только для типов без конструкторов - блоков и частей)
+template <typename T>
+class ScratchBuffer {
+private:
+    ScratchArena& arena_;
+    size_t bytes_;
+    T* data_;
+
+    ScratchBuffer(const ScratchBuffer&);
+    ScratchBuffer& operator=(const ScratchBuffer&);
+
+public:
+    explicit ScratchBuffer(size_t count)
+        : arena_(ScratchArena::local()), bytes_(count * sizeof(T)),
+          data_(static_cast<T*>(arena_.allocate(bytes_))) {}
+    ~ScratchBuffer() { arena_.release(data_, bytes_); }
+
+    T* data() { return data_; }
+    T& operator[](size_t i) { return data_[i]; }
+};
+
+// --- Пул рабочих потоков ---
+
+// Общий пул потоков для пакетных операций и крупных умножений/делений. Задание - группа
+// независимых задач: run_tasks(count, body) выполняет body(i) для i из [0, count), parallel_for
+// делит диапазон на куски. Задачи попадают в общую очередь: свободные потоки пула забирают самые
+// старые (крупные) задачи с начала очереди, а поток, ждущий свою группу, сам выполняет самые новые
+// с конца. Поэтому вложенные задания (рекурсия Toom-3 внутри задачи NTT и т. п.) не блокируют
+// друг друга и не простаивают. Разбиение на задачи не зависит от числа потоков, так что результат
+// один и тот же; при одном потоке (set_threads(1)) все задачи выполняются по порядку в вызывающем
+// потоке. Каждый поток берет рабочую память из своей ScratchArena
+class WorkerPool {
+public:
+    // Общий пул; по умолчанию потоков столько, сколько ядер
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    // Число потоков, включая вызывающий (0 - по числу ядер, 1 - без параллельности).
+    // Вызывается, пока пул не выполняет задания
+    void set_threads(size_t threads) {
+        stop_workers();
+        if (threads == 0) threads = hardware_threads();
+        start_workers(threads);
+    }
+
+    size_t threads() const { return workers_.size() + 1; }
+
+    // body(i) для i из [0, count); задача 0 выполняется в вызывающем потоке.
+    // Первое исключение из задач передается вызывающему после завершения всей группы
+    template <typename Body>
+    void run_tasks(size_t count, const Body& body) {
+        if (workers_.empty() || count < 2) {
+            for (size_t i = 0; i < count; ++i) body(i);
+            return;
+        }
+
+        Group group;
+        group.pending.store(count - 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 1; i < count; ++i) {
+                Task task = { &invoke_task<Body>, &body, i, &group };
+                queue_.push_back(task);
+            }
+        }
+        wake_.notify_all();
+
+        try {
+            body(0);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!group.error) group.error = std::current_exception();
+        }
+        wait(group);
+        if (group.error) std::rethrow_exception(group.error);
+    }
+
+    // body(begin, end) для кусков [begin, end) по chunk элементов диапазона [0, count).
+    // Куски разбираются через атомарный счетчик не более чем threads() задачами
+    template <typename Body>
+    void parallel_for(size_t count, size_t chunk, const Body& body) {
+        if (chunk == 0) chunk = 1;
+        size_t chunks = (count + chunk - 1) / chunk;
+        size_t tasks = chunks < threads() ? chunks : threads();
+        if (tasks < 2) {
+            body(0, count);
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        run_tasks(tasks, [&](size_t) {
+            for (;;) {
+                size_t begin = next.fetch_add(chunk);
+                if (begin >= count) break;
+                size_t end = count - begin < chunk ? count : begin + chunk;
+                try {
+                    body(begin, end);
+                } catch (...) {
+                    next.store(count); // Оставшиеся куски пропускаются
+                    throw;
+                }
+            }
+        });
+    }
+
+    ~WorkerPool() { stop_workers(); }
+
+private:
+    struct Group {
+        std::atomic<size_t> pending; // Задачи группы в очереди или в работе (кроме задачи 0)
+        std::exception_ptr error;    // Первое исключение из задач группы
+    };
+
+    struct Task {
+        void (*invoke)(const void*, size_t);
+        const void* body;
+        size_t index;
+        Group* group;
+    };
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;               // Очередь, ошибки групп, остановка
+    std::condition_variable wake_;   // Новые задачи, завершение группы, остановка
+    std::deque<Task> queue_;
+    bool stop_;
+
+    WorkerPool() : stop_(false) { start_workers(hardware_threads()); }
+
+    WorkerPool(const WorkerPool&);
+    WorkerPool& operator=(const WorkerPool&);
+
+    static size_t hardware_threads() {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    template <typename Body>
+    static void invoke_task(const void* body, size_t index) {
+        (*static_cast<const Body*>(body))(index);
+    }
+
+    // Выполнение задачи из очереди; последняя задача группы будит ждущий поток
+    void execute(const Task& task) {
+        try {
+            task.invoke(task.body, task.index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!task.group->error) task.group->error = std::current_exception();
+        }
+        if (task.group->pending.fetch_sub(1) == 1) { // Дальше группа может быть уже уничтожена
+            { std::lock_guard<std::mutex> lock(mutex_); }
+            wake_.notify_all();
+        }
+    }
+
+    // Ожидание группы: пока она не завершена, поток выполняет задачи с конца очереди
+    void wait(Group& group) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (group.pending.load() != 0) {
+            if (queue_.empty()) {
+                wake_.wait(lock);
+                continue;
+            }
+            Task task = queue_.back();
+            queue_.pop_back();
+            lock.unlock();
+            execute(task);
+            lock.lock();
+        }
+    }
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+            Task task = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            execute(task);
+            lock.lock();
+        }
+    }
+
+    void start_workers(size_t threads) {
+        for (size_t i = 1; i < threads; ++i) workers_.push_back(std::thread(&WorkerPool::worker_loop, this));
+    }
+
+    void stop_workers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < workers_.size(); ++i) workers_[i].join();
+        workers_.clear();
+        stop_ = false;
+    }
+};
+
+// Параметры ширины блока числа: двойной блок (без знака и со знаком) и пороги выбора
+// алгоритма умножения (в блоках меньшего из сомножителей). Пороги подобраны замерами отдельно
+// для каждой ширины: ниже karatsuba_threshold быстрее умножение "столбиком", начиная с
+// toom3_threshold - алгоритм Тоома-Кука (Toom-3), с ntt_threshold - теоретико-числовое преобразование.
+// Начиная с parallel_threshold блоков подпроизведения раздаются потокам WorkerPool;
+// деление с делителем и частным от div_dc_threshold блоков - рекурсивное (Бурникель-Циглер)
+template <typename Limb>
+struct LimbTraits;
+
+template <>
+struct LimbTraits<unsigned int> {
+    typedef unsigned long long wide_type;
+    typedef long long signed_wide_type;
+    static const size_t karatsuba_threshold = 32;
+    static const size_t toom3_threshold = 200;
+    static const size_t ntt_threshold = 7000;
+    static const size_t parallel_threshold = 2400;
+    static const size_t div_dc_threshold = 48;
+};
+
+template <>
+struct LimbTraits<unsigned long long> {
+    typedef unsigned __int128 wide_type;
+    typedef __int128 signed_wide_type;
+    static const size_t karatsuba_threshold = 32;
+    static const size_t toom3_threshold = 200;
+    static const size_t ntt_threshold = 12000;
+    static const size_t parallel_threshold = 1200;
+    static const size_t div_dc_threshold = 24;
+};
+
+// --- Ядра над блоками и выбор набора инструкций ---
+// Горячие ядра (переносы сложения и вычитания, умножение строки на блок, сдвиги, сравнение,
+// битовые операции) собраны в нескольких вариантах: скалярный эталон и версии для SSE4.2,
+// AVX2 и AVX-512 (атрибут target, векторы по 16, 32 и 64 байта). Вариант выбирается один раз,
+// при первом обращении, по cpuid (__builtin_cpu_supports), поэтому программу не нужно собирать
+// с -march=native: одна и та же сборка работает на любом x86-64 и использует лучшие инструкции
+// процессора. Переменная окружения BIGINT_CPU=scalar|sse4|avx2|avx512 принудительно выбирает
+// уровень не выше найденного - для проверки и замеров.
+
+// Уровни наборов инструкций, от младшего к старшему
+enum CpuTier { CPU_TIER_SCALAR, CPU_TIER_SSE4, CPU_TIER_AVX2, CPU_TIER_AVX512, CPU_TIER_COUNT };
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BIGINT_TARGET_SSE4 __attribute__((target("sse4.2")))
+#define BIGINT_TARGET_AVX2 __attribute__((target("avx2")))
+#define BIGINT_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else // Другие процессоры: векторы расширения GCC без особых инструкций, выбирается скалярный уровень
+#define BIGINT_TARGET_SSE4
+#define BIGINT_TARGET_AVX2
+#define BIGINT_TARGET_AVX512
+#endif
+// Тела ядер встраиваются в обертку каждого уровня и компилируются с ее набором инструкций
+#define BIGINT_KERNEL_INLINE __attribute__((always_inline)) inline
+
+class CpuDispatch {
+public:
+    // Старший уровень, который поддерживают процессор и ОС
+    static CpuTier detected() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return CPU_TIER_AVX512;
+        if (__builtin_cpu_supports("avx2")) return CPU_TIER_AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return CPU_TIER_SSE4;
+#endif
+        return CPU_TIER_SCALAR;
+    }
+
+    // Уровень, с которым работают числа: найденный или заданный BIGINT_CPU (выбирается один раз)
+    static CpuTier selected() {
+        static const CpuTier tier = choose();
+        return tier;
+    }
+
+    static const char* name(CpuTier tier) {
+        static const char* const names[CPU_TIER_COUNT] = { "scalar", "sse4", "avx2", "avx512" };
+        return names[tier];
+    }
+
+private:
+    static CpuTier choose() {
+        CpuTier tier = detected();
+        const char* forced = getenv("BIGINT_CPU");
+        if (forced) { // Уровень выше найденного не выбирается: его инструкции процессор не выполнит
+            for (int lower = CPU_TIER_SCALAR; lower < tier; ++lower) {
+                if (strcmp(forced, name((CpuTier)lower)) == 0) return (CpuTier)lower;
+            }
+        }
+        return tier;
+    }
+};
+
+// Битовые операции ядра bitwise
+enum BitwiseOp { BITWISE_AND, BITWISE_OR, BITWISE_XOR, BITWISE_OP_COUNT };
+
+// Вектор блоков из Bytes байт (расширение векторов GCC/Clang); при Bytes = 0 - один блок,
+// и те же тела ядер дают скалярный эталон
+template <typename Limb, size_t Bytes>
+struct LimbVector {
+    typedef Limb type __attribute__((vector_size(Bytes)));
+};
+
+template <typename Limb>
+struct LimbVector<Limb, 0> {
+    typedef Limb type;
+};
+
+// Тела ядер (блоки little endian, модули без знака). Основные циклы векторных ядер - по два
+// вектора за шаг: GCC с -O2 сам не векторизует циклы с неизвестной длиной
+template <typename Limb, size_t VectorBytes>
+struct LimbKernelBodies {
+    typedef typename LimbTraits<Limb>::wide_type dlimb_t;
+    typedef typename LimbVector<Limb, VectorBytes>::type vector_t;
+    static const size_t LANES = sizeof(vector_t) / sizeof(Limb);
+    static const int BITS = sizeof(Limb) * 8;
+
+    // r = a + b (an >= bn), r содержит an блоков; возвращает перенос из старшего блока
+    BIGINT_KERNEL_INLINE static Limb add_limbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+        dlimb_t carry = 0;
+        size_t i = 0;
+        for (; i < bn; ++i) {
+            dlimb_t sum = (dlimb_t)a[i] + b[i] + carry;
+            r[i] = (Limb)sum;
+            carry = sum >> BITS;
+        }
+        for (; i < an; ++i) {
+            dlimb_t sum = (dlimb_t)a[i] + carry;
+            r[i] = (Limb)sum;
+            carry = sum >> BITS;
+        }
+        return (Limb)carry;
+    }
+
+    // r = a - b (an >= bn), r содержит an блоков; возвращает заем из старшего блока
+    BIGINT_KERNEL_INLINE static Limb sub_limbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {
+        Limb borrow = 0;
+        size_t i = 0;
+        for (; i < bn; ++i) {
+            dlimb_t diff = (dlimb_t)a[i] - b[i] - borrow;
+            r[i] = (Limb)diff;
+            borrow = (Limb)(diff >> BITS) & 1;
+        }
+        for (; i < an; ++i) {
+            dlimb_t diff = (dlimb_t)a[i] - borrow;
+            r[i] = (Limb)diff;
+            borrow = (Limb)(diff >> BITS) & 1;
+        }
+        return borrow;
+    }
+
+    // Сравнение модулей разной длины (ведущие нули допускаются). Общая часть просматривается
+    // сверху парами векторов до первого несовпадения, которое затем ищется по блокам;
+    // старший блок проверяется отдельно - разные числа чаще всего различаются уже в нем
+    BIGINT_KERNEL_INLINE static int compare_limbs(const Limb* a, size_t an, const Limb* b, size_t bn) {
+        while (an > bn) if (a[--an] != 0) return 1;
+        while (bn > an) if (b[--bn] != 0) return -1;
+        if (an > 0 && a[an - 1] != b[an - 1]) return a[an - 1] < b[an - 1] ? -1 : 1;
+        size_t i = an;
+        for (; i >= 2 * LANES; i -= 2 * LANES) {
+            vector_t x0, x1, y0, y1;
+            memcpy(&x0, a + i - LANES, sizeof(x0));
+            memcpy(&x1, a + i - 2 * LANES, sizeof(x1));
+            memcpy(&y0, b + i - LANES, sizeof(y0));
+            memcpy(&y1, b + i - 2 * LANES, sizeof(y1));
+            vector_t diff = (x0 ^ y0) | (x1 ^ y1);
+            Limb lanes[LANES];
+            memcpy(lanes, &diff, sizeof(diff));
+            Limb any = 0;
+            for (size_t k = 0; k < LANES; ++k) any |= lanes[k];
+            if (any) break;
+        }
+        while (i-- > 0) {
+            if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // r = a * m (n блоков); возвращает старший блок произведения
+    BIGINT_KERNEL_INLINE static Limb mul_1(Limb* r, const Limb* a, size_t n, Limb m) {
+        dlimb_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t product = (dlimb_t)a[i] * m + carry;
+            r[i] = (Limb)product;
+            carry = product >> BITS;
+        }
+        return (Limb)carry;
+    }
+
+    // r = r + a * m на месте (n блоков); возвращает перенос из старшего блока
+    BIGINT_KERNEL_INLINE static Limb addmul_1(Limb* r, const Limb* a, size_t n, Limb m) {
+        dlimb_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t product = (dlimb_t)a[i] * m + r[i] + carry;
+            r[i] = (Limb)product;
+            carry = product >> BITS;
+        }
+        return (Limb)carry;
+    }
+
+    // r = r - a * m на месте (n блоков); возвращает заем из старшего блока
+    BIGINT_KERNEL_INLINE static Limb submul_1(Limb* r, const Limb* a, size_t n, Limb m) {
+        Limb borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t product = (dlimb_t)a[i] * m + borrow; // Не больше 2^(2*bits) - 2^bits
+            Limb low = (Limb)product;
+            Limb current = r[i];
+            r[i] = current - low;
+            borrow = (Limb)(product >> BITS) + (current < low ? 1 : 0);
+        }
+        return borrow;
+    }
+
+    // r = a << s (0 <= s < бит в блоке) для n >= 1 блоков; возвращает биты, вытесненные из старшего блока.
+    // Блоки сдвигаются и склеиваются за один проход сверху вниз, поэтому r может совпадать с a
+    // или лежать выше него (сдвиг на целые блоки в том же массиве)
+    BIGINT_KERNEL_INLINE static Limb shift_left_limbs(Limb* r, const Limb* a, size_t n, int s) {
+        if (s == 0) {
+            memmove(r, a, n * sizeof(Limb));
+            return 0;
+        }
+        const int back = BITS - s;
+        Limb high = a[n - 1] >> back;
+        size_t i = n; // Блоки r[i, n) готовы
+        for (; i > 2 * LANES; i -= 2 * LANES) {
+            // Блоки [i - 2V, i) и соседние снизу [i - 2V - 1, i - 1); все загрузки - до записей
+            vector_t x0, x1, y0, y1;
+            memcpy(&x0, a + i - LANES, sizeof(x0));
+            memcpy(&y0, a + i - LANES - 1, sizeof(y0));
+            memcpy(&x1, a + i - 2 * LANES, sizeof(x1));
+            memcpy(&y1, a + i - 2 * LANES - 1, sizeof(y1));
+            x0 = (x0 << s) | (y0 >> back);
+            x1 = (x1 << s) | (y1 >> back);
+            memcpy(r + i - LANES, &x0, sizeof(x0));
+            memcpy(r + i - 2 * LANES, &x1, sizeof(x1));
+        }
+        for (; i > 1; --i) r[i - 1] = (a[i - 1] << s) | (a[i - 2] >> back);
+        r[0] = a[0] << s;
+        return high;
+    }
+
+    // r = a >> s (0 <= s < бит в блоке) для n >= 1 блоков, биты младшего блока отбрасываются.
+    // Проход снизу вверх: r может совпадать с a или лежать ниже него
+    BIGINT_KERNEL_INLINE static void shift_right_limbs(Limb* r, const Limb* a, size_t n, int s) {
+        if (s == 0) {
+            memmove(r, a, n * sizeof(Limb));
+            return;
+        }
+        const int back = BITS - s;
+        size_t i = 0; // Блоки r[0, i) готовы
+        for (; i + 2 * LANES < n; i += 2 * LANES) {
+            // Блоки [i, i + 2V) и соседние сверху [i + 1, i + 2V + 1); все загрузки - до записей
+            vector_t x0, x1, y0, y1;
+            memcpy(&x0, a + i, sizeof(x0));
+            memcpy(&y0, a + i + 1, sizeof(y0));
+            memcpy(&x1, a + i + LANES, sizeof(x1));
+            memcpy(&y1, a + i + LANES + 1, sizeof(y1));
+            x0 = (x0 >> s) | (y0 << back);
+            x1 = (x1 >> s) | (y1 << back);
+            memcpy(r + i, &x0, sizeof(x0));
+            memcpy(r + i + LANES, &x1, sizeof(x1));
+        }
+        for (; i + 1 < n; ++i) r[i] = (a[i] >> s) | (a[i + 1] << back);
+        r[n - 1] = a[n - 1] >> s;
+    }
+
+    // r[i] = ((a[i] ^ a_mask) Op (b[i] ^ b_mask)) ^ r_mask для n блоков; r может совпадать с a, но не с b
+    template <int Op>
+    BIGINT_KERNEL_INLINE static void bitwise(Limb* r, const Limb* a, Limb a_mask, const Limb* b, Limb b_mask,
+                                             Limb r_mask, size_t n) {
+        size_t i = 0;
+        for (; i + 2 * LANES <= n; i += 2 * LANES) {
+            vector_t x0, x1, y0, y1;
+            memcpy(&x0, a + i, sizeof(x0));
+            memcpy(&x1, a + i + LANES, sizeof(x1));
+            memcpy(&y0, b + i, sizeof(y0));
+            memcpy(&y1, b + i + LANES, sizeof(y1));
+            x0 ^= a_mask;
+            x1 ^= a_mask;
+            y0 ^= b_mask;
+            y1 ^= b_mask;
+            x0 = (Op == BITWISE_AND ? x0 & y0 : Op == BITWISE_OR ? x0 | y0 : x0 ^ y0) ^ r_mask;
+            x1 = (Op == BITWISE_AND ? x1 & y1 : Op == BITWISE_OR ? x1 | y1 : x1 ^ y1) ^ r_mask;
+            memcpy(r + i, &x0, sizeof(x0));
+            memcpy(r + i + LANES, &x1, sizeof(x1));
+        }
+        for (; i < n; ++i) {
+            Limb x = a[i] ^ a_mask;
+            Limb y = b[i] ^ b_mask;
+            r[i] = (Op == BITWISE_AND ? x & y : Op == BITWISE_OR ? x | y : x ^ y) ^ r_mask;
+        }
+    }
+};
+
+// Таблица ядер одного уровня
+template <typename Limb>
+struct LimbKernels {
+    Limb (*add_limbs)(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn);
+    Limb (*sub_limbs)(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn);
+    int (*compare_limbs)(const Limb* a, size_t an, const Limb* b, size_t bn);
+    Limb (*mul_1)(Limb* r, const Limb* a, size_t n, Limb m);
+    Limb (*addmul_1)(Limb* r, const Limb* a, size_t n, Limb m);
+    Limb (*submul_1)(Limb* r, const Limb* a, size_t n, Limb m);
+    Limb (*shift_left_limbs)(Limb* r, const Limb* a, size_t n, int s);
+    void (*shift_right_limbs)(Limb* r, const Limb* a, size_t n, int s);
+    void (*bitwise[BITWISE_OP_COUNT])(Limb* r, const Limb* a, Limb a_mask, const Limb* b, Limb b_mask,
+                                      Limb r_mask, size_t n);
+
+    // Ядра уровня tier (уровень должен поддерживаться процессором)
+    static LimbKernels for_tier(CpuTier tier);
+
+    // Ядра уровня CpuDispatch::selected(); таблица заполняется при первом обращении
+    static const LimbKernels& selected() {
+        static const LimbKernels table = for_tier(CpuDispatch::selected());
+        return table;
+    }
+
+    // Итог сверки: число расхождений и условия первого из них (ядро, длины операндов, сдвиг)
+    struct CrossCheck {
+        size_t mismatches;
+        const char* kernel;
+        size_t a_size;
+        size_t b_size;
+        int shift;
+    };
+
+    // Сверка ядер уровня tier со скалярным эталоном на rounds наборах псевдослучайных блоков
+    // (длины до 200, серии нулей и единиц для длинных переносов, ядра на месте)
+    static CrossCheck cross_check(CpuTier tier, size_t rounds);
+};
+
+// Обертки уровня: тела ядер, скомпилированные с набором инструкций Target и векторами VectorBytes
+#define BIGINT_DEFINE_TIER_KERNELS(Name, Target, VectorBytes)                                              \
+    template <typename Limb>                                                                               \
+    struct Name {                                                                                          \
+        typedef LimbKernelBodies<Limb, VectorBytes> Bodies;                                                \
+        Target static Limb add_limbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {        \
+            return Bodies::add_limbs(r, a, an, b, bn);                                                     \
+        }                                                                                                  \
+        Target static Limb sub_limbs(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn) {        \
+            return Bodies::sub_limbs(r, a, an, b, bn);                                                     \
+        }                                                                                                  \
+        Target static int compare_limbs(const Limb* a, size_t an, const Limb* b, size_t bn) {              \
+            return Bodies::compare_limbs(a, an, b, bn);                                                    \
+        }                                                                                                  \
+        Target static Limb mul_1(Limb* r, const Limb* a, size_t n, Limb m) {                               \
+            return Bodies::mul_1(r, a, n, m);                                                              \
+        }                                                                                                  \
+        Target static Limb addmul_1(Limb* r, const Limb* a, size_t n, Limb m) {                            \
+            return Bodies::addmul_1(r, a, n, m);                                                           \
+        }                                                                                                  \
+        Target static Limb submul_1(Limb* r, const Limb* a, size_t n, Limb m) {                            \
+            return Bodies::submul_1(r, a, n, m);                                                           \
+        }                                                                                                  \
+        Target static Limb shift_left_limbs(Limb* r, const Limb* a, size_t n, int s) {                     \
+            return Bodies::shift_left_limbs(r, a, n, s);                                                   \
+        }                                                                                                  \
+        Target static void shift_right_limbs(Limb* r, const Limb* a, size_t n, int s) {                    \
+            Bodies::shift_right_limbs(r, a, n, s);                                                         \
+        }                                                                                                  \
+        template <int Op>                                                                                  \
+        Target static void bitwise(Limb* r, const Limb* a, Limb a_mask, const Limb* b, Limb b_mask,        \
+                                   Limb r_mask, size_t n) {                                                \
+            Bodies::template bitwise<Op>(r, a, a_mask, b, b_mask, r_mask, n);                              \
+        }                                                                                                  \
+        static LimbKernels<Limb> table() {                                                                 \
+            LimbKernels<Limb> kernels = { add_limbs, sub_limbs, compare_limbs, mul_1, addmul_1, submul_1,  \
+                                          shift_left_limbs, shift_right_limbs,                             \
+                                          { bitwise<BITWISE_AND>, bitwise<BITWISE_OR>, bitwise<BITWISE_XOR> } }; \
+            return kernels;                                                                                \
+        }                                                                                                  \
+    };
+
+BIGINT_DEFINE_TIER_KERNELS(ScalarKernels, , 0)
+BIGINT_DEFINE_TIER_KERNELS(Sse4Kernels, BIGINT_TARGET_SSE4, 16)
+BIGINT_DEFINE_TIER_KERNELS(Avx2Kernels, BIGINT_TARGET_AVX2, 32)
+BIGINT_DEFINE_TIER_KERNELS(Avx512Kernels, BIGINT_TARGET_AVX512, 64)
+
+template <typename Limb>
+LimbKernels<Limb> LimbKernels<Limb>::for_tier(CpuTier tier) {
+    switch (tier) {
+    case CPU_TIER_SSE4: return Sse4Kernels<Limb>::table();
+    case CPU_TIER_AVX2: return Avx2Kernels<Limb>::table();
+    case CPU_TIER_AVX512: return Avx512Kernels<Limb>::table();
+    default: return ScalarKernels<Limb>::table();
+    }
+}
+
+template <typename Limb>
+typename LimbKernels<Limb>::CrossCheck LimbKernels<Limb>::cross_check(CpuTier tier, size_t rounds) {
+    const size_t max_size = 200;
+    LimbKernels reference = for_tier(CPU_TIER_SCALAR);
+    LimbKernels checked = for_tier(tier);
+    std::vector<Limb> a(max_size), b(max_size), r1(max_size + 1), r2(max_size + 1);
+    unsigned long long seed = 12345;
+    CrossCheck result = { 0, 0, 0, 0, 0 };
+
+    for (size_t round = 0; round < rounds; ++round) {
+        size_t an = 1 + round % max_size;
+        size_t bn = 1 + (round * 7919) % an;
+        int mode = (int)(round % 4); // Случайные блоки; с сериями нулей; с сериями единиц; b - копия a
+        for (size_t i = 0; i < max_size; ++i) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            Limb x = (Limb)(seed >> 13) ^ (Limb)(seed << 21);
+            a[i] = mode == 1 && (seed >> 60) < 10 ? 0 : mode == 2 && (seed >> 60) < 10 ? (Limb)~(Limb)0 : x;
+            b[i] = mode == 3 ? a[i] : (Limb)(x * 2654435761u + (Limb)(seed >> 40));
+        }
+        if (mode == 3 && an > 2) b[an / 2] ^= 1; // Отличие в середине
+
+        Limb m = a[max_size - 1] | 1;
+        int s = (int)(seed % (sizeof(Limb) * 8));
+        Limb mask_a = (seed >> 61) & 1 ? (Limb)~(Limb)0 : 0;
+        Limb mask_b = (seed >> 62) & 1 ? (Limb)~(Limb)0 : 0;
+        Limb mask_r = (seed >> 63) & 1 ? (Limb)~(Limb)0 : 0;
+
+        // Учет расхождения; условия запоминаются для первого
+        auto differ = [&](const char* kernel, bool mismatch) {
+            if (!mismatch || result.mismatches++ != 0) return;
+            result.kernel = kernel;
+            result.a_size = an;
+            result.b_size = bn;
+            result.shift = s;
+        };
+
+        // Результат: возвращаемое значение и блоки r
+        Limb c1 = reference.add_limbs(r1.data(), a.data(), an, b.data(), bn);
+        Limb c2 = checked.add_limbs(r2.data(), a.data(), an, b.data(), bn);
+        differ("add_limbs", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+        c1 = reference.sub_limbs(r1.data(), a.data(), an, b.data(), bn);
+        c2 = checked.sub_limbs(r2.data(), a.data(), an, b.data(), bn);
+        differ("sub_limbs", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+        differ("compare_limbs", reference.compare_limbs(a.data(), an, b.data(), bn) != checked.compare_limbs(a.data(), an, b.data(), bn));
+        differ("compare_limbs", reference.compare_limbs(a.data(), an, a.data(), an) != checked.compare_limbs(a.data(), an, a.data(), an));
+        differ("compare_limbs", reference.compare_limbs(b.data(), bn, a.data(), an) != checked.compare_limbs(b.data(), bn, a.data(), an));
+        c1 = reference.mul_1(r1.data(), a.data(), an, m);
+        c2 = checked.mul_1(r2.data(), a.data(), an, m);
+        differ("mul_1", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+        memcpy(r1.data(), b.data(), an * sizeof(Limb));
+        memcpy(r2.data(), b.data(), an * sizeof(Limb));
+        c1 = reference.addmul_1(r1.data(), a.data(), an, m);
+        c2 = checked.addmul_1(r2.data(), a.data(), an, m);
+        differ("addmul_1", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+        c1 = reference.submul_1(r1.data(), a.data(), an, m);
+        c2 = checked.submul_1(r2.data(), a.data(), an, m);
+        differ("submul_1", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+
+        // Сдвиги: в отдельный массив и на месте со смещением на блок (r выше или ниже a)
+        c1 = reference.shift_left_limbs(r1.data(), a.data(), an, s);
+        c2 = checked.shift_left_limbs(r2.data(), a.data(), an, s);
+        differ("shift_left_limbs", c1 != c2 || memcmp(r1.data(), r2.data(), an * sizeof(Limb)) != 0);
+        memcpy(r1.data(), a.data(), an * sizeof(Limb));
+        memcpy(r2.data(), a.data(), an * sizeof(Limb));
+        c1 = reference.shift_left_limbs(r1.data() + 1, r1.data(), an, s);
+        c2 = checked.shift_left_limbs(r2.data() + 1, r2.data(), an, s);
+        differ("shift_left_limbs", c1 != c2 || memcmp(r1.data(), r2.data(), (an + 1) * sizeof(Limb)) != 0);
+        reference.shift_right_limbs(r1.data(), r1.data() + 1, an, s);
+        checked.shift_right_limbs(r2.data(), r2.data() + 1, an, s);
+        differ("shift_right_limbs", memcmp(r1.data(), r2.data(), (an + 1) * sizeof(Limb)) != 0);
+
+        // Битовые операции: в отдельный массив и на месте (r совпадает с a)
+        for (int op = 0; op < BITWISE_OP_COUNT; ++op) {
+            reference.bitwise[op](r1.data(), a.data(), mask_a, b.data(), mask_b, mask_r, bn);
+            checked.bitwise[op](r2.data(), a.data(), mask_a, b.data(), mask_b, mask_r, bn);
+            differ("bitwise", memcmp(r1.data(), r2.data(), bn * sizeof(Limb)) != 0);
+            checked.bitwise[op](r2.data(), r2.data(), mask_r, a.data(), mask_a, mask_b, bn);
+            reference.bitwise[op](r1.data(), r1.data(), mask_r, a.data(), mask_a, mask_b, bn);
+            differ("bitwise", memcmp(r1.data(), r2.data(), bn * sizeof(Limb)) != 0);
+        }
+    }
+    return result;
+}
+
+// --- Двоичный формат ---
+
+// Версионированный двоичный формат чисел; все слова - 64 бита, little endian на любой платформе.
+// Запись числа: слово (количество слов модуля << 1 | знак), затем слова модуля, младшее первым,
+// старшее ненулевое (у нуля слов нет). Формат не зависит от ширины блока: на little endian
+// слова модуля - это сами блоки числа, поэтому запись и чтение сводятся к копированию памяти.
+// Поток записей начинается с заголовка (write_header): "BIGNUMS\0" и слово версии;
+// столбцовый файл (ColumnFile) - с "BIGCOLS\0" и той же версии
+struct BinaryFormat {
+    static const unsigned int VERSION = 1;
+    static const size_t HEADER_BYTES = 16;
+    // Модуль читается из потока кусками не длиннее READ_CHUNK_WORDS слов, и память под него растет
+    // по мере прихода данных: поврежденное слово размера не приводит к выделению под заявленный размер
+    static const size_t READ_CHUNK_WORDS = (size_t)1 << 16;
+
+    static bool host_little_endian() { return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__; }
+
+    // Чтение и запись 64-битного слова little endian по невыровненному адресу
+    static unsigned long long load(const void* p) {
+        unsigned long long value;
+        memcpy(&value, p, sizeof(value));
+        return host_little_endian() ? value : __builtin_bswap64(value);
+    }
+
+    static void store(void* p, unsigned long long value) {
+        if (!host_little_endian()) value = __builtin_bswap64(value);
+        memcpy(p, &value, sizeof(value));
+    }
+
+    // Заголовок: магическая строка из 8 байт и слово версии
+    static void write_header(std::ostream& os, const char* magic = "BIGNUMS") {
+        unsigned char header[HEADER_BYTES] = {};
+        memcpy(header, magic, strlen(magic) < 8 ? strlen(magic) : 8);
+        store(header + 8, VERSION);
+        os.write((const char*)header, HEADER_BYTES);
+    }
+
+    // false - поток закончился, другой формат или неизвестная версия
+    static bool check_header(const unsigned char* header, const char* magic) {
+        unsigned char expected[8] = {};
+        memcpy(expected, magic, strlen(magic) < 8 ? strlen(magic) : 8);
+        return memcmp(header, expected, 8) == 0 && load(header + 8) == VERSION;
+    }
+
+    static bool read_header(std::istream& is, const char* magic = "BIGNUMS") {
+        unsigned char header[HEADER_BYTES];
+        if (!is.read((char*)header, HEADER_BYTES)) return false;
+        return check_header(header, magic);
+    }
+};
+
+// Длинное целое с блоками типа Limb (unsigned int или unsigned long long).
+// Ширина блока - параметр шаблона, чтобы сравнивать 32- и 64-битные блоки на одном и том же коде;
+// в программе используется BigInteger (см. BIGINT_LIMB_BITS в конце файла)
+template <typename Limb>
+class BasicBigInteger {
+private:
+    typedef BasicBigInteger BigInteger; // Короткое имя внутри класса
+    typedef Limb limb_t;                                    // Блок числа без знака
+    typedef typename LimbTraits<Limb>::wide_type dlimb_t;   // Двойной блок для произведений и переносов
+    typedef typename LimbTraits<Limb>::signed_wide_type sdlimb_t; // Двойной блок со знаком (коэффициенты НОД)
+
+    static const size_t KARATSUBA_THRESHOLD = LimbTraits<Limb>::karatsuba_threshold;
+    static const size_t TOOM3_THRESHOLD = LimbTraits<Limb>::toom3_threshold;
+    static const size_t NTT_THRESHOLD = LimbTraits<Limb>::ntt_threshold;
+    static const size_t PARALLEL_THRESHOLD = LimbTraits<Limb>::parallel_threshold;
+    static const size_t DIV_DC_THRESHOLD = LimbTraits<Limb>::div_dc_threshold;
+    // Количество 32-битных частей в блоке (NTT и конструктор от массива int работают с ними)
+    static const size_t PIECES_PER_LIMB = sizeof(limb_t) / sizeof(unsigned int);
+    static const int PIECE_BITS = 32;
+
+    limb_t* digits;                // Массив блоков (little endian): inline_digits или куча
+    size_t digits_size;            // Текущее количество используемых элементов digits
+    size_t digits_capacity;        // Количество элементов, под которые выделена память
+    bool is_negative;              // Знак числа
+    bool is_small_value;           // Флаг оптимизации для малых значений
+    small_int_t small_value;       // Значение для оптимизации (если is_small_value = true)
+    limb_t inline_digits[INLINE_BIGINT_DIGITS]; // Встроенный буфер для небольших чисел
+
+    // Количество блоков под модуль small_value
+    static const size_t SMALL_LIMBS = sizeof(small_uint_t) / sizeof(limb_t);
+
+    // Вспомогательные функции для констант (не зависят от объекта)
+    static int get_bits_per_limb() { return sizeof(limb_t) * 8; }
+
+    // Модуль small_value без знака (в том числе для SMALL_INT_MIN)
+    static small_uint_t small_magnitude(small_int_t value) {
+        return value < 0 ? (small_uint_t)0 - (small_uint_t)value : (small_uint_t)value;
+    }
+
+    // Запись модуля в SMALL_LIMBS блоков; возвращает количество значащих блоков
+    static size_t small_to_limbs(small_uint_t magnitude, limb_t* out) {
+        size_t size = 0;
+        for (size_t i = 0; i < SMALL_LIMBS; ++i) {
+            out[i] = (limb_t)(magnitude >> (i * get_bits_per_limb()));
+            if (out[i] != 0) size = i + 1;
+        }
+        return size;
+    }
+
+    // --- Управление памятью ---
+
+    // Используется ли память в куче (а не встроенный буфер)
+    bool uses_heap() const { return digits != inline_digits; }
+
+    // Освобождение памяти в куче и возврат к встроенному буферу
+    void release_storage() {
+        if (uses_heap()) delete[] digits;
+        digits = inline_digits;
+        digits_capacity = INLINE_BIGINT_DIGITS;
+    }
+
+    // Гарантирует место под new_capacity элементов, сохраняя первые digits_size элементов
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= digits_capacity) return;
+        size_t grown = digits_capacity * 2;
+        if (grown > new_capacity) new_capacity = grown;
+
+        limb_t* new_digits = new limb_t[new_capacity];
+        memcpy(new_digits, digits, digits_size * sizeof(limb_t));
+        if (uses_heap()) delete[] digits;
+        digits = new_digits;
+        digits_capacity = new_capacity;
+    }
+
+    // Изменение количества используемых элементов (новые элементы заполняются нулями)
+    void resize(size_t new_size) {
+        reserve(new_size);
+        if (new_size > digits_size) {
+            memset(digits + digits_size, 0, (new_size - digits_size) * sizeof(limb_t));
+        }
+        digits_size = new_size;
+    }
+
+    // Копирование значения другого числа (память переиспользуется, если ее хватает)
+    void copy_from(const BigInteger& other) {
+        is_negative = other.is_negative;
+        is_small_value = other.is_small_value;
+        small_value = other.small_value;
+        digits_size = 0;
+        if (!is_small_value) {
+            reserve(other.digits_size);
+            memcpy(digits, other.digits, other.digits_size * sizeof(limb_t));
+        }
+        digits_size = other.digits_size;
+    }
+
+    // Перемещение значения другого числа (память в куче забирается без копирования)
+    void move_from(BigInteger& other) {
+        is_negative = other.is_negative;
+        is_small_value = other.is_small_value;
+        small_value = other.small_value;
+        if (other.uses_heap()) {
+            release_storage();
+            digits = other.digits;
+            digits_capacity = other.digits_capacity;
+            other.digits = other.inline_digits;
+            other.digits_capacity = INLINE_BIGINT_DIGITS;
+        } else {
+            memcpy(digits, other.digits, other.digits_size * sizeof(limb_t));
+        }
+        digits_size = other.digits_size;
+
+        // Оставляем other в корректном состоянии (ноль)
+        other.digits_size = 0;
+        other.is_negative = false;
+        other.is_small_value = true;
+        other.small_value = 0;
+    }
+
+    // Проверка, помещается ли число в small_value
+    bool fits_in_small() const {
+        if (digits_size > SMALL_LIMBS) return false; // Больше блоков, чем в small_value
+        if (digits_size == 0) return true; // Число 0, оптимизировано как 0
+
+        // Блоки хранят модуль, а не знаковое значение; у отрицательных допустим модуль SMALL_INT_MIN
+        small_uint_t max_abs = (small_uint_t)SMALL_INT_MAX + (is_negative ? 1 : 0);
+        return small_from_limbs() <= max_abs;
+    }
+
+    // Модуль из блоков числа (digits_size <= SMALL_LIMBS)
+    small_uint_t small_from_limbs() const {
+        small_uint_t magnitude = 0;
+        for (size_t i = 0; i < digits_size; ++i) {
+            magnitude |= (small_uint_t)digits[i] << (i * get_bits_per_limb());
+        }
+        return magnitude;
+    }
+
+    // Присваивание значения в формате small_value (память блоков остается за объектом)
+    void assign_small(small_int_t value) {
+        is_negative = false;
+        is_small_value = true;
+        small_value = value;
+        digits_size = 0;
+    }
+
+    // Оптимизация для малых значений (переход в small_value формат)
+    void try_optimize() {
+        if (is_small_value) return; // Уже в формате small_value
+
+        if (digits_size == 0) { // Если массив пуст (в результате normalize или другого), это 0
+            is_small_value = true;
+            small_value = 0;
+            is_negative = false;
+            return;
+        }
+
+        if (fits_in_small()) {
+            small_uint_t magnitude = small_from_limbs();
+            // Знак через unsigned, чтобы корректно получить SMALL_INT_MIN
+            assign_small((small_int_t)(is_negative ? (small_uint_t)0 - magnitude : magnitude));
+        }
+    }
+
+    // Переход из small_value формата в big_integer формат
+    void ensure_big_format() {
+        if (is_small_value) {
+            bool was_negative = (small_value < 0);
+
+            // Встроенного буфера всегда хватает на SMALL_LIMBS блоков; ноль - один нулевой блок
+            size_t size = small_to_limbs(small_magnitude(small_value), digits);
+            digits_size = size != 0 ? size : 1;
+
+            is_negative = was_negative;
+            is_small_value = false;
+        }
+    }
+
+    // Нормализация (удаление ведущих нулей из digits)
+    void normalize() {
+        while (digits_size > 1 && digits[digits_size - 1] == 0) {
+            digits_size--;
+        }
+        if (digits_size == 1 && digits[0] == 0) {
+            is_negative = false;
+        }
+    }
+
+    // Модуль числа в виде блоков без копирования и выделения памяти.
+    // Модуль small_value хранится в блоках внутри самого представления,
+    // поэтому представление нельзя копировать (указатель limbs может ссылаться на них).
+    class MagnitudeView {
+    private:
+        limb_t small_limbs[SMALL_LIMBS];
+
+        MagnitudeView(const MagnitudeView&);
+        MagnitudeView& operator=(const MagnitudeView&);
+
+    public:
+        const limb_t* limbs; // Блоки модуля (little endian)
+        size_t size;         // Количество блоков (0 для нуля в small_value формате)
+        bool negative;       // Знак числа
+
+        explicit MagnitudeView(const BigInteger& x) {
+            if (x.is_small_value) {
+                negative = x.small_value < 0;
+                limbs = small_limbs;
+                size = small_to_limbs(small_magnitude(x.small_value), small_limbs);
+            } else {
+                limbs = x.digits;
+                size = x.digits_size;
+                negative = x.is_negative;
+            }
+        }
+    };
+
+    // Сравнение абсолютных значений (используется для арифметики и сравнения)
+    //-1 если abs(this) < abs(other), 0 если равны, 1 если abs(this) > abs(other)
+    int compare_abs(const BigInteger& other) const {
+        MagnitudeView a(*this);
+        MagnitudeView b(other);
+        return compare_limbs(a.limbs, a.size, b.limbs, b.size);
+    }
+
+    // Сравнение с учетом знака: -1 если this < other, 0 если равны, 1 если this > other
+    int compare(const BigInteger& other) const {
+        if (is_small_value && other.is_small_value) {
+            return (small_value > other.small_value) - (small_value < other.small_value);
+        }
+
+        MagnitudeView a(*this);
+        MagnitudeView b(other);
+        if (a.negative != b.negative) return a.negative ? -1 : 1; // Ноль всегда неотрицателен
+        int cmp = compare_limbs(a.limbs, a.size, b.limbs, b.size);
+        return a.negative ? -cmp : cmp; // У отрицательных чисел больше то, что меньше по модулю
+    }
+
+    // Проверка равенства: сравнение блоков через memcmp без учета порядка (быстрее, чем compare)
+    bool equals(const BigInteger& other) const {
+        if (is_small_value && other.is_small_value) return small_value == other.small_value;
+
+        MagnitudeView a(*this);
+        MagnitudeView b(other);
+        if (a.negative != b.negative || a.size != b.size) return false;
+        return memcmp(a.limbs, b.limbs, a.size * sizeof(limb_t)) == 0;
+    }
+
+    // Сложение (subtract == false) или вычитание (subtract == true) other на месте, без копии other
+    BigInteger& add_signed(const BigInteger& other, bool subtract) {
+        if (is_small_value && other.is_small_value) {
+            small_int_t result;
+            bool overflow = subtract ? __builtin_sub_overflow(small_value, other.small_value, &result)
+                                     : __builtin_add_overflow(small_value, other.small_value, &result);
+            if (!overflow) {
+                small_value = result;
+                return *this;
+            }
+        }
+
+        // x += x и x -= x: блоки other менялись бы по ходу вычисления
+        if (this == &other) {
+            if (subtract) *this = BigInteger(0);
+            else *this <<= 1;
+            return *this;
+        }
+
+        ensure_big_format();
+        MagnitudeView b(other);
+        return add_magnitude(b.limbs, b.size, b.negative != subtract);
+    }
+
+    // *this += (b_negative ? -|b| : |b|), где |b| - модуль из bn блоков вне этого числа
+    BigInteger& add_magnitude(const limb_t* b, size_t bn, bool b_negative) {
+        ensure_big_format();
+        size_t a_size = digits_size;
+
+        if (is_negative == b_negative) { // Знаки одинаковые - складываем модули
+            size_t n = a_size > bn ? a_size : bn;
+            resize(n + 1); // Место под возможный перенос в старший блок
+            digits[n] = add_limbs(digits, digits, n, b, bn);
+        } else if (compare_limbs(digits, a_size, b, bn) >= 0) {
+            // Знаки разные, |this| >= |b|: знак остается прежним
+            sub_limbs(digits, digits, a_size, b, bn);
+        } else {
+            // Знаки разные, |this| < |b|: результат |b| - |this| со знаком b
+            resize(bn);
+            sub_limbs(digits, b, bn, digits, a_size);
+            is_negative = b_negative;
+        }
+        normalize();
+        try_optimize();
+        return *this;
+    }
+
+    // *this += b * c (subtract: *this -= b * c) без временного BigInteger под произведение.
+    // Если меньший сомножитель короче порога Карацубы, произведение прибавляется (вычитается)
+    // прямо по блокам числа строками addmul_1 (submul_1); иначе оно строится в рабочем буфере
+    BigInteger& add_product(const BigInteger& b, const BigInteger& c, bool subtract) {
+        if (is_small_value && b.is_small_value && c.is_small_value) {
+            small_int_t product, result;
+            if (!__builtin_mul_overflow(b.small_value, c.small_value, &product) &&
+                !(subtract ? __builtin_sub_overflow(small_value, product, &result)
+                           : __builtin_add_overflow(small_value, product, &result))) {
+                small_value = result;
+                return *this;
+            }
+        }
+        if (this == &b || this == &c) return add_signed(b * c, subtract); // Сомножитель меняется по ходу
+        if (b.is_zero() || c.is_zero()) return *this;
+
+        MagnitudeView x(b), y(c);
+        const limb_t* longer = x.limbs;
+        const limb_t* shorter = y.limbs;
+        size_t long_size = x.size, short_size = y.size;
+        if (long_size < short_size) {
+            longer = y.limbs; shorter = x.limbs;
+            long_size = y.size; short_size = x.size;
+        }
+        bool product_negative = (x.negative != y.negative) != subtract;
+        size_t product_size = long_size + short_size;
+
+        ensure_big_format();
+        if (short_size < KARATSUBA_THRESHOLD) {
+            // Лишний старший блок: модуль суммы помещается в n - 1 блоков, поэтому при вычитании
+            // отрицательная разность видна по старшему биту (дополнительный код)
+            size_t n = (digits_size > product_size ? digits_size : product_size) + 1;
+            resize(n);
+            bool add = (is_negative == product_negative);
+            for (size_t i = 0; i < short_size; ++i) {
+                if (add) {
+                    limb_t carry = addmul_1(digits + i, longer, long_size, shorter[i]);
+                    for (size_t k = i + long_size; carry != 0; ++k) { // Перенос затухает за пару блоков
+                        digits[k] += carry;
+                        carry = digits[k] < carry ? 1 : 0;
+                    }
+                } else {
+                    limb_t borrow = submul_1(digits + i, longer, long_size, shorter[i]);
+                    for (size_t k = i + long_size; borrow != 0 && k < n; ++k) {
+                        limb_t old = digits[k];
+                        digits[k] = old - borrow;
+                        borrow = old < borrow ? 1 : 0;
+                    }
+                }
+            }
+            if (digits[n - 1] >> (get_bits_per_limb() - 1)) { // |this| < |b * c|: меняем знак модуля
+                limb_t carry = 1;
+                for (size_t k = 0; k < n; ++k) {
+                    digits[k] = ~digits[k] + carry;
+                    carry = (carry && digits[k] == 0) ? 1 : 0;
+                }
+                is_negative = !is_negative;
+            }
+            normalize();
+            try_optimize();
+            return *this;
+        }
+
+        ScratchBuffer<limb_t> product(product_size);
+        mul_limbs(longer, long_size, shorter, short_size, product.data());
+        while (product_size > 1 && product[product_size - 1] == 0) --product_size;
+        return add_magnitude(product.data(), product_size, product_negative);
+    }
+
+    // Встроенное целое: знак и модуль до 64 бит
+    struct Integer {
+        unsigned long long magnitude;
+        bool negative;
+
+        Integer(long long value)
+            : magnitude(value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value),
+              negative(value < 0) {}
+        Integer(unsigned long long value) : magnitude(value), negative(false) {}
+
+        bool fits_small() const { return (small_uint_t)magnitude <= (small_uint_t)SMALL_INT_MAX; }
+        small_int_t small() const { return negative ? -(small_int_t)magnitude : (small_int_t)magnitude; }
+        bool fits_limb() const { return magnitude <= (unsigned long long)(limb_t)-1; } // 32-битные блоки - не всегда
+    };
+
+    // Знаковые типы приводятся к long long (int64_t), беззнаковые - к unsigned long long (uint64_t)
+    template <typename T>
+    static Integer to_integer(T value) {
+        return Integer((typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type)value);
+    }
+
+    // Число из встроенного целого (для модулей длиннее блока)
+    static BigInteger from_integer(const Integer& b) {
+        limb_t limbs[SMALL_LIMBS];
+        BigInteger result = from_limbs(limbs, small_to_limbs(b.magnitude, limbs));
+        if (b.negative) result.negate();
+        return result;
+    }
+
+    // *this += b (subtract: *this -= b) без временного BigInteger: small_value - со встроенной
+    // проверкой переполнения, иначе add_1/sub_1 по блокам. Перенос (заем) обычно останавливается
+    // в младшем блоке, поэтому ++ и -- длинного числа стоят O(1) в среднем
+    BigInteger& add_integer(Integer b, bool subtract) {
+        if (subtract) b.negative = !b.negative;
+        if (is_small_value && b.fits_small()) {
+            small_int_t result;
+            if (!__builtin_add_overflow(small_value, b.small(), &result)) {
+                small_value = result;
+                return *this;
+            }
+        }
+        if (b.magnitude == 0) return *this;
+
+        ensure_big_format();
+        if (!b.fits_limb()) {
+            limb_t limbs[SMALL_LIMBS];
+            return add_magnitude(limbs, small_to_limbs(b.magnitude, limbs), b.negative);
+        }
+        limb_t m = (limb_t)b.magnitude;
+        if (is_negative == b.negative) { // Знаки одинаковые - складываем модули
+            limb_t carry = add_1(digits, digits_size, m);
+            if (carry != 0) {
+                resize(digits_size + 1);
+                digits[digits_size - 1] = carry;
+            }
+        } else if (digits_size > 1 || digits[0] >= m) { // |this| >= |b|: знак остается прежним
+            sub_1(digits, digits_size, m);
+        } else {
+            digits[0] = m - digits[0];
+            is_negative = b.negative;
+        }
+        normalize();
+        try_optimize();
+        return *this;
+    }
+
+    // *this *= b: один проход mul_1 на месте
+    BigInteger& mul_integer(const Integer& b) {
+        if (is_small_value && b.fits_small()) {
+            small_int_t result;
+            if (!__builtin_mul_overflow(small_value, b.small(), &result)) {
+                small_value = result;
+                return *this;
+            }
+        }
+        if (b.magnitude == 0 || is_zero()) {
+            assign_small(0);
+            return *this;
+        }
+        if (!b.fits_limb()) return *this *= from_integer(b);
+
+        ensure_big_format();
+        size_t n = digits_size;
+        resize(n + 1);
+        digits[n] = mul_1(digits, digits, n, (limb_t)b.magnitude);
+        is_negative = is_negative != b.negative;
+        normalize();
+        try_optimize();
+        return *this;
+    }
+
+    // *this * b в отдельном числе: mul_1 пишет сразу в буфер результата
+    BigInteger product_integer(const Integer& b) const {
+        if (is_small_value || b.magnitude == 0 || !b.fits_limb()) {
+            BigInteger result = *this;
+            result.mul_integer(b);
+            return result;
+        }
+        BigInteger result;
+        result.is_small_value = false;
+        result.resize(digits_size + 1);
+        result.digits[digits_size] = mul_1(result.digits, digits, digits_size, (limb_t)b.magnitude);
+        result.is_negative = is_negative != b.negative;
+        result.normalize();
+        result.try_optimize();
+        return result;
+    }
+
+    // *this /= b (remainder: *this %= b) с округлением к нулю, как у divmod; при b == 0 результат 0.
+    // Делитель из одного блока - один проход divmod_1 на месте
+    BigInteger& div_integer(const Integer& b, bool remainder) {
+        if (b.magnitude == 0) {
+            assign_small(0);
+            return *this;
+        }
+        if (is_small_value && b.fits_small() && !(small_value == SMALL_INT_MIN && b.small() == -1)) {
+            small_value = remainder ? small_value % b.small() : small_value / b.small();
+            return *this;
+        }
+        if (!b.fits_limb()) {
+            BigInteger quotient, rest;
+            divmod(*this, from_integer(b), quotient, rest);
+            *this = std::move(remainder ? rest : quotient);
+            return *this;
+        }
+
+        ensure_big_format();
+        limb_t rest = divmod_1(remainder ? 0 : digits, digits, digits_size, LimbDivisor((limb_t)b.magnitude));
+        if (remainder) { // Знак остатка - знак делимого
+            digits_size = 1;
+            digits[0] = rest;
+        } else {
+            is_negative = is_negative != b.negative;
+        }
+        normalize();
+        try_optimize();
+        return *this;
+    }
+
+    // *this % b без копии делимого: остаток одного блока считается прямо по блокам числа
+    BigInteger remainder_integer(const Integer& b) const {
+        if (is_small_value || b.magnitude == 0 || !b.fits_limb()) {
+            BigInteger result = *this;
+            result.div_integer(b, true);
+            return result;
+        }
+        BigInteger result = from_limb(divmod_1(0, digits, digits_size, LimbDivisor((limb_t)b.magnitude)));
+        if (is_negative) result.negate();
+        return result;
+    }
+
+    // Сравнение со встроенным целым: -1, 0 или 1
+    int compare_integer(const Integer& b) const {
+        if (is_small_value && b.fits_small()) {
+            small_int_t value = b.small();
+            return (small_value > value) - (small_value < value);
+        }
+        MagnitudeView a(*this);
+        if (a.negative != b.negative) return a.negative ? -1 : 1;
+        limb_t limbs[SMALL_LIMBS];
+        size_t size = small_to_limbs(b.magnitude, limbs);
+        int cmp = 0;
+        if (a.size != size) { // Модуль нормализован: длинное число больше
+            cmp = a.size < size ? -1 : 1;
+        } else {
+            for (size_t i = size; cmp == 0 && i-- > 0;) {
+                if (a.limbs[i] != limbs[i]) cmp = a.limbs[i] < limbs[i] ? -1 : 1;
+            }
+        }
+        return a.negative ? -cmp : cmp;
+    }
+
+    // result = a * b; result - отдельный от a и b объект. Буфер берется с запасом в один блок,
+    // чтобы следующее сложение в цепочке (a * b + c) не перевыделяло память
+    static void multiply_into(const BigInteger& a, const BigInteger& b, BigInteger& result) {
+        if (a.is_small_value && b.is_small_value) {
+            small_int_t product;
+            if (!__builtin_mul_overflow(a.small_value, b.small_value, &product)) {
+                result.assign_small(product);
+                return;
+            }
+        }
+
+        MagnitudeView x(a), y(b);
+        if (x.size == 0 || y.size == 0) { // Умножение на 0
+            result = BigInteger(0);
+            return;
+        }
+
+        result.is_small_value = false;
+        result.small_value = 0;
+        result.digits_size = 0;
+        if (x.size + y.size > INLINE_BIGINT_DIGITS) result.reserve(x.size + y.size + 1);
+        result.resize(x.size + y.size);
+        if (&a == &b) sqr_limbs(x.limbs, x.size, result.digits);
+        else mul_limbs(x.limbs, x.size, y.limbs, y.size, result.digits);
+        result.is_negative = (x.negative != y.negative);
+        result.normalize();
+        result.try_optimize();
+    }
+
+    // Количество ведущих нулевых битов в блоке (x != 0)
+    static int count_leading_zeros(limb_t x) {
+        if (sizeof(limb_t) == sizeof(unsigned long long)) return __builtin_clzll((unsigned long long)x);
+        return __builtin_clz((unsigned int)x);
+    }
+
+    // Число младших нулевых битов блока (x != 0)
+    static int count_trailing_zeros(limb_t x) {
+        if (sizeof(limb_t) == sizeof(unsigned long long)) return __builtin_ctzll((unsigned long long)x);
+        return __builtin_ctz((unsigned int)x);
+    }
+
+    // Вспомогательная функция для деления модулей, возвращает частное и остаток за один проход.
+    // Оба числа должны быть в big формате; знаки игнорируются, результаты неотрицательны.
+    // Длинное деление "столбиком" (алгоритм D Кнута, TAOCP т.2, 4.3.1): O(n*m) операций над блоками;
+    // при длинных делителе и частном - рекурсивное деление Бурникеля-Циглера (div_dc).
+    void divide_internal(const BigInteger& divisor, BigInteger& quotient, BigInteger& remainder) const {
+        size_t n = divisor.digits_size;
+
+        // Если делитель равен нулю, деление невозможно
+        if (n == 1 && divisor.digits[0] == 0) {
+            quotient = BigInteger(0); // Или выбросить исключение
+            remainder = BigInteger(0);
+            return;
+        }
+
+        // Если делимое меньше делителя, частное 0, остаток - делимое
+        if (compare_abs(divisor) < 0) {
+            quotient = BigInteger(0);
+            remainder = *this;
+            remainder.is_negative = false;
+            remainder.try_optimize();
+            return;
+        }
+
+        size_t m = digits_size - n;
+        BigInteger q;
+        q.is_small_value = false;
+        q.resize(m + 1);
+        limb_t* qd = q.digits;
+
+        // Делитель из одного блока: один проход divmod_1 с предвычисленной обратной величиной
+        if (n == 1) {
+            limb_t rem = divmod_1(qd, digits, digits_size, LimbDivisor(divisor.digits[0]));
+            q.normalize();
+            q.try_optimize();
+            quotient = std::move(q);
+
+            BigInteger r;
+            r.is_small_value = false;
+            r.resize(1);
+            r.digits[0] = rem;
+            r.try_optimize();
+            remainder = std::move(r);
+            return;
+        }
+
+        // D1: нормализация - сдвигаем так, чтобы старший бит делителя был равен 1.
+        // Тогда оценка очередной цифры частного ошибается не более чем на 2.
+        int s = count_leading_zeros(divisor.digits[n - 1]);
+        ScratchBuffer<limb_t> vn(n);
+        ScratchBuffer<limb_t> un(digits_size + 1);
+        shift_left_limbs(vn.data(), divisor.digits, n, s);
+        un[digits_size] = shift_left_limbs(un.data(), digits, digits_size, s);
+
+        // D2-D7: частное "столбиком" или рекурсивно, если и делитель, и частное длинные
+        if (n >= DIV_DC_THRESHOLD && m + 1 >= DIV_DC_THRESHOLD) {
+            div_dc(qd, un.data(), m + 1, vn.data(), n);
+        } else {
+            div_schoolbook(qd, un.data(), m + 1, vn.data(), n);
+        }
+
+        q.normalize();
+        q.try_optimize();
+        quotient = std::move(q);
+
+        // D8: остаток - младшие n блоков, сдвинутые обратно
+        BigInteger r;
+        r.is_small_value = false;
+        r.resize(n);
+        shift_right_limbs(r.digits, un.data(), n, s);
+        r.normalize();
+        r.try_optimize();
+        remainder = std::move(r);
+    }
+
+    // --- Ядра деления (делитель нормализован: старший бит старшего блока равен 1) ---
+
+    // Деление "столбиком": u содержит n + k блоков, старшие n из них меньше v (n >= 2).
+    // В q записываются k блоков частного, остаток остается в младших n блоках u
+    static void div_schoolbook(limb_t* q, limb_t* u, size_t k, const limb_t* v, size_t n) {
+        const dlimb_t base = (dlimb_t)1 << get_bits_per_limb();
+        for (size_t j = k; j-- > 0;) {
+            // D3: оценка цифры частного по двум старшим блокам остатка
+            dlimb_t num = ((dlimb_t)u[j + n] << get_bits_per_limb()) | u[j + n - 1];
+            dlimb_t qhat = num / v[n - 1];
+            dlimb_t rhat = num % v[n - 1];
+            while (qhat >= base || qhat * v[n - 2] > ((rhat << get_bits_per_limb()) | u[j + n - 2])) {
+                qhat--;
+                rhat += v[n - 1];
+                if (rhat >= base) break;
+            }
+
+            // D4: вычитаем qhat * делитель из текущего окна остатка
+            limb_t carry = 0;  // Старший блок очередного произведения qhat * v[i]
+            limb_t borrow = 0; // Заем вычитания
+            for (size_t i = 0; i < n; ++i) {
+                dlimb_t p = qhat * v[i] + carry;
+                carry = (limb_t)(p >> get_bits_per_limb());
+                dlimb_t t = (dlimb_t)u[i + j] - (limb_t)p - borrow;
+                u[i + j] = (limb_t)t;
+                borrow = (limb_t)(t >> get_bits_per_limb()) & 1;
+            }
+            dlimb_t t = (dlimb_t)u[j + n] - carry - borrow;
+            u[j + n] = (limb_t)t;
+
+            // D5-D6: если вычли слишком много (qhat больше на 1), добавляем делитель обратно
+            q[j] = (limb_t)qhat;
+            if ((t >> get_bits_per_limb()) != 0) {
+                q[j]--;
+                u[j + n] += add_limbs(u + j, u + j, n, v, n);
+            }
+        }
+    }
+
+    // Рекурсивное деление Бурникеля-Циглера ("Fast Recursive Division", 1998), те же условия,
+    // что у div_schoolbook. Частное считается блоками по n цифр от старших к младшим; в каждом блоке
+    // цифра частного оценивается делением на старшую часть v, а поправка - умножение на младшую
+    // часть, которое через mul_limbs попадает в быстрые (и параллельные) ядра умножения.
+    // Стоимость - O(M(n) log n) на блок вместо O(n^2)
+    static void div_dc(limb_t* q, limb_t* u, size_t k, const limb_t* v, size_t n) {
+        size_t first = k % n ? k % n : n; // Старший блок частного может быть неполным
+        for (size_t position = k - first, size = first;; size = n) {
+            div_dc_step(q + position, u + position, size, v, n);
+            if (position == 0) break;
+            position -= n;
+        }
+    }
+
+    // Один блок частного из k <= n цифр: u содержит n + k блоков, старшие n из них меньше v
+    static void div_dc_step(limb_t* q, limb_t* u, size_t k, const limb_t* v, size_t n) {
+        if (k < DIV_DC_THRESHOLD) {
+            div_schoolbook(q, u, k, v, n);
+            return;
+        }
+
+        // D2n/1n: старшая и младшая половины частного по очереди
+        if (k == n) {
+            size_t low = k / 2;
+            div_dc_step(q + low, u + low, k - low, v, n);
+            div_dc_step(q, u, low, v, n);
+            return;
+        }
+
+        // D3n/2n: оценка частного делением старших 2k блоков u на старшие k блоков v
+        // (ошибается не более чем на 2, так как v нормализовано)
+        const limb_t* v_high = v + n - k;
+        limb_t* u_high = u + n - k;
+        limb_t top = 0; // Блок остатка над младшими n блоками
+        if (compare_limbs(u + n, k, v_high, k) < 0) {
+            div_dc_step(q, u_high, k, v_high, k);
+        } else {
+            // Старшие k блоков u равны v_high: частное B^k - 1, остаток - средние k блоков u плюс v_high
+            for (size_t i = 0; i < k; ++i) q[i] = (limb_t)-1;
+            top = add_limbs(u_high, u_high, k, v_high, k);
+        }
+
+        // Вычитаем q * (младшие n - k блоков v); пока остаток отрицателен, q уменьшается на 1
+        ScratchBuffer<limb_t> product(n);
+        mul_limbs(q, k, v, n - k, product.data());
+        limb_t borrow = sub_limbs(u, u, n, product.data(), n);
+        bool negative = borrow > top;
+        top -= borrow;
+        while (negative) {
+            for (size_t i = 0; i < k && q[i]-- == 0; ++i) {}
+            if (add_limbs(u, u, n, v, n)) negative = ++top != 0;
+        }
+    }
+
+    // --- Ядра для одного блока ---
+
+    // a += b на месте (n блоков); перенос идет только до первого блока без переполнения,
+    // поэтому обычно проход заканчивается на младшем блоке. Возвращает перенос из старшего блока
+    static limb_t add_1(limb_t* a, size_t n, limb_t b) {
+        for (size_t i = 0; i < n; ++i) {
+            a[i] += b;
+            if (a[i] >= b) return 0;
+            b = 1;
+        }
+        return b;
+    }
+
+    // a -= b на месте (n блоков); возвращает заем из старшего блока
+    static limb_t sub_1(limb_t* a, size_t n, limb_t b) {
+        for (size_t i = 0; i < n; ++i) {
+            limb_t old = a[i];
+            a[i] = old - b;
+            if (old >= b) return 0;
+            b = 1;
+        }
+        return b;
+    }
+
+    // Делитель из одного блока с предвычисленной обратной величиной (Möller, Granlund,
+    // "Improved division by invariant integers", 2011): деление двух блоков на блок - два
+    // умножения и поправка вместо аппаратного деления. Делитель хранится нормализованным
+    struct LimbDivisor {
+        limb_t d;       // Делитель, сдвинутый влево на shift бит (старший бит равен 1)
+        limb_t inverse; // floor((B^2 - 1) / d) - B, B = 2^bits
+        int shift;
+
+        explicit LimbDivisor(limb_t divisor) : shift(count_leading_zeros(divisor)) {
+            d = divisor << shift;
+            inverse = (limb_t)(~(dlimb_t)0 / d); // Частное из [B, 2B), старший бит отбрасывается
+        }
+
+        // (u1 * B + u0) / d при u1 < d; остаток записывается в u1
+        limb_t divide(limb_t& u1, limb_t u0) const {
+            dlimb_t q = (dlimb_t)inverse * u1 + (((dlimb_t)(u1 + 1) << get_bits_per_limb()) | u0);
+            limb_t q1 = (limb_t)(q >> get_bits_per_limb());
+            limb_t r = u0 - q1 * d;
+            if (r > (limb_t)q) { // Оценка больше частного на 1
+                q1--;
+                r += d;
+            }
+            if (r >= d) { // Оценка меньше частного на 1 (редко)
+                q1++;
+                r -= d;
+            }
+            u1 = r;
+            return q1;
+        }
+    };
+
+    // q = a / d (n блоков); возвращает остаток. q может совпадать с a или быть нулевым - тогда
+    // считается только остаток. Делимое сдвигается на d.shift бит по ходу того же прохода
+    static limb_t divmod_1(limb_t* q, const limb_t* a, size_t n, const LimbDivisor& d) {
+        if (n == 0) return 0;
+        const int bits = get_bits_per_limb();
+        if (d.shift == 0) {
+            limb_t r = 0;
+            for (size_t i = n; i-- > 0;) {
+                limb_t digit = d.divide(r, a[i]);
+                if (q) q[i] = digit;
+            }
+            return r;
+        }
+        limb_t r = a[n - 1] >> (bits - d.shift); // Старший блок сдвинутого делимого, меньше d
+        for (size_t i = n; i-- > 0;) {
+            limb_t low = i > 0 ? a[i - 1] >> (bits - d.shift) : 0;
+            limb_t digit = d.divide(r, (a[i] << d.shift) | low);
+            if (q) q[i] = digit;
+        }
+        return r >> d.shift;
+    }
+
+    // --- Ядра умножения (работают с модулями, блоки little endian) ---
+
+    // Ядра уровня, выбранного при старте по процессору (см. LimbKernels и CpuDispatch)
+    static const LimbKernels<limb_t>& kernels() { return LimbKernels<limb_t>::selected(); }
+
+    // r = a + b (an >= bn), r содержит an блоков; возвращает перенос из старшего блока
+    static limb_t add_limbs(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        return kernels().add_limbs(r, a, an, b, bn);
+    }
+
+    // r = a - b (an >= bn), r содержит an блоков; возвращает заем из старшего блока
+    static limb_t sub_limbs(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        return kernels().sub_limbs(r, a, an, b, bn);
+    }
+
+    // Сравнение модулей разной длины (ведущие нули допускаются)
+    static int compare_limbs(const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        return kernels().compare_limbs(a, an, b, bn);
+    }
+
+    // Умножение "столбиком": r = a * b, r содержит an + bn блоков
+    static void mul_schoolbook(const limb_t* a, size_t an, const limb_t* b, size_t bn, limb_t* r) {
+        if (a == b && an == bn) {
+            sqr_schoolbook(a, an, r);
+            return;
+        }
+        // Строки идут по длинному сомножителю: меньше вызовов ядер, и каждый - на более длинной строке
+        if (an < bn) {
+            const limb_t* tp = a; a = b; b = tp;
+            size_t tn = an; an = bn; bn = tn;
+        }
+        if (bn == 0) {
+            memset(r, 0, an * sizeof(limb_t));
+            return;
+        }
+        r[an] = mul_1(r, a, an, b[0]);
+        for (size_t j = 1; j < bn; ++j) {
+            r[j + an] = addmul_1(r + j, a, an, b[j]);
+        }
+    }
+
+    // Возведение в квадрат "столбиком" с учетом симметрии: произведения a[i]*a[j] при i < j
+    // считаются один раз и удваиваются сдвигом, затем добавляются квадраты a[i]^2 -
+    // около n^2/2 умножений блоков вместо n^2. r содержит 2n блоков
+    static void sqr_schoolbook(const limb_t* a, size_t n, limb_t* r) {
+        memset(r, 0, 2 * n * sizeof(limb_t));
+        for (size_t i = 0; i + 1 < n; ++i) {
+            r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        }
+
+        // Удвоение (сумма произведений при i < j меньше a^2 / 2, старший бит не теряется)
+        limb_t high_bit = 0;
+        for (size_t i = 0; i < 2 * n; ++i) {
+            limb_t next = r[i] >> (get_bits_per_limb() - 1);
+            r[i] = (r[i] << 1) | high_bit;
+            high_bit = next;
+        }
+
+        dlimb_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t square = (dlimb_t)a[i] * a[i];
+            dlimb_t low = (dlimb_t)r[2 * i] + (limb_t)square + carry;
+            r[2 * i] = (limb_t)low;
+            dlimb_t high = (dlimb_t)r[2 * i + 1] + (limb_t)(square >> get_bits_per_limb()) + (low >> get_bits_per_limb());
+            r[2 * i + 1] = (limb_t)high;
+            carry = high >> get_bits_per_limb();
+        }
+    }
+
+    // Размер рабочей области для mul_karatsuba от n блоков
+    static size_t karatsuba_scratch_size(size_t n) {
+        if (n < KARATSUBA_THRESHOLD) return 0;
+        size_t low = (n + 1) / 2;
+        return 6 * low + 1 + karatsuba_scratch_size(low);
+    }
+
+    // Умножение Карацубы (вычитательный вариант) для сомножителей из n блоков:
+    // a*b = z2*B^2l + (z0 + z2 + (a0 - a1)(b1 - b0))*B^l + z0.
+    // r содержит 2n блоков; ws - общая для всей рекурсии рабочая область karatsuba_scratch_size(n).
+    // Если a и b - один и тот же массив, все три произведения - квадраты, средний вычитается
+    static void mul_karatsuba(const limb_t* a, const limb_t* b, size_t n, limb_t* r, limb_t* ws) {
+        if (n < KARATSUBA_THRESHOLD) {
+            mul_schoolbook(a, n, b, n, r);
+            return;
+        }
+
+        size_t low = (n + 1) / 2; // Размер младших половин
+        size_t high = n - low;    // Размер старших половин (high <= low)
+
+        limb_t* diff_a = ws;             // |a0 - a1|, low блоков
+        limb_t* diff_b = ws + low;       // |b1 - b0|, low блоков
+        limb_t* middle = ws + 2 * low;   // Произведение разностей, 2*low блоков
+        limb_t* sum = ws + 4 * low;      // z0 + z2 -/+ middle, 2*low + 1 блоков
+        limb_t* rest = ws + 6 * low + 1; // Рабочая область для рекурсии
+
+        // z0 и z2 сразу на свои места в результате
+        mul_karatsuba(a, b, low, r, rest);
+        mul_karatsuba(a + low, b + low, high, r + 2 * low, rest);
+
+        // Модули разностей половин и знак их произведения
+        bool middle_negative = false;
+        if (compare_limbs(a, low, a + low, high) >= 0) {
+            sub_limbs(diff_a, a, low, a + low, high);
+        } else {
+            diff_a[low - 1] = 0;
+            sub_limbs(diff_a, a + low, high, a, high);
+            middle_negative = !middle_negative;
+        }
+        if (a == b) { // (a0 - a1)(a1 - a0) = -(a0 - a1)^2
+            diff_b = diff_a;
+            middle_negative = true;
+        } else if (compare_limbs(b + low, high, b, low) >= 0) {
+            diff_b[low - 1] = 0;
+            sub_limbs(diff_b, b + low, high, b, high);
+        } else {
+            sub_limbs(diff_b, b, low, b + low, high);
+            middle_negative = !middle_negative;
+        }
+        mul_karatsuba(diff_a, diff_b, low, middle, rest);
+
+        // Средний коэффициент: z0 + z2 +/- middle (всегда неотрицателен)
+        memcpy(sum, r, 2 * low * sizeof(limb_t));
+        sum[2 * low] = add_limbs(sum, sum, 2 * low, r + 2 * low, 2 * high);
+        if (middle_negative) {
+            sub_limbs(sum, sum, 2 * low + 1, middle, 2 * low);
+        } else {
+            add_limbs(sum, sum, 2 * low + 1, middle, 2 * low);
+        }
+
+        // Прибавляем средний коэффициент со сдвигом на low блоков
+        size_t sum_size = 2 * low + 1;
+        while (sum_size > 2 * n - low) sum_size--; // Лишние старшие блоки заведомо нулевые
+        add_limbs(r + low, r + low, 2 * n - low, sum, sum_size);
+    }
+
+    // r = (+/-)a + (+/-)b для чисел со знаком из n блоков (результат обязан поместиться в n блоков).
+    // r может совпадать с a или b. Возвращает знак результата (true - отрицательный, у нуля - false)
+    static bool add_signed(limb_t* r, const limb_t* a, bool a_negative, const limb_t* b, bool b_negative, size_t n) {
+        if (a_negative == b_negative) {
+            add_limbs(r, a, n, b, n);
+            return a_negative;
+        }
+        int cmp = compare_limbs(a, n, b, n);
+        if (cmp == 0) {
+            memset(r, 0, n * sizeof(limb_t));
+            return false;
+        }
+        if (cmp > 0) {
+            sub_limbs(r, a, n, b, n);
+            return a_negative;
+        }
+        sub_limbs(r, b, n, a, n);
+        return b_negative;
+    }
+
+    // Точное деление на 3 на месте (остаток заведомо равен нулю).
+    // Без деления двойных блоков: от младшего блока умножаем на обратный к 3 по модулю 2^bits
+    // (0xAA...AB), а число "переполнений" 3 * q >= 2^bits переносим заемом в следующий блок
+    static void divexact_by3(limb_t* a, size_t n) {
+        const limb_t inverse3 = (limb_t)-1 / 3 * 2 + 1;
+        const limb_t third = (limb_t)-1 / 3; // floor((2^bits - 1) / 3)
+        limb_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            limb_t cur = a[i] - borrow;
+            limb_t next_borrow = a[i] < borrow ? 1 : 0;
+            limb_t q = cur * inverse3;
+            a[i] = q;
+            borrow = next_borrow + (q > third ? 1 : 0) + (q > 2 * third ? 1 : 0);
+        }
+    }
+
+    // Значения многочлена a2*x^2 + a1*x + a0 в точках 1, -1, -2 (по k + 1 блоку, со знаком).
+    // parts - три части, дополненные нулями до k + 1 блока
+    static void toom3_evaluate(const limb_t* parts, size_t k, limb_t* p1, limb_t* p_m1, bool& p_m1_negative,
+                               limb_t* p_m2, bool& p_m2_negative) {
+        size_t w = k + 1;
+        const limb_t* a0 = parts;
+        const limb_t* a1 = parts + w;
+        const limb_t* a2 = parts + 2 * w;
+
+        add_limbs(p1, a0, w, a2, w);                                        // a0 + a2
+        p_m1_negative = add_signed(p_m1, p1, false, a1, true, w);           // a0 - a1 + a2
+        add_limbs(p1, p1, w, a1, w);                                        // a0 + a1 + a2
+        p_m2_negative = add_signed(p_m2, p_m1, p_m1_negative, a2, false, w); // a0 - a1 + 2*a2
+        add_limbs(p_m2, p_m2, w, p_m2, w);                                  // удвоение
+        p_m2_negative = add_signed(p_m2, p_m2, p_m2_negative, a0, true, w); // a0 - 2*a1 + 4*a2
+    }
+
+    // Умножение Тоома-Кука (Toom-3) для сомножителей из n блоков: каждый делится на три части,
+    // вычисляются значения в точках 0, 1, -1, -2 и бесконечности (5 умножений размера n/3 вместо 9),
+    // затем коэффициенты восстанавливаются интерполяцией по последовательности Бодрато.
+    // Рекурсивные умножения снова проходят через диспетчер mul_limbs, начиная с PARALLEL_THRESHOLD -
+    // параллельно в потоках WorkerPool. Если a и b - один и тот же массив, значения в точках считаются
+    // один раз и все пять произведений - квадраты
+    static void mul_toom3(const limb_t* a, const limb_t* b, size_t n, limb_t* r) {
+        size_t k = (n + 2) / 3;   // Размер младших частей
+        size_t top = n - 2 * k;   // Размер старшей части
+        size_t w = k + 1;         // Размер значений в точках
+        size_t width = 2 * w;     // Размер произведений и промежуточных коэффициентов
+
+        ScratchBuffer<limb_t> workspace(12 * w + 7 * width);
+        limb_t* a_parts = workspace.data();
+        limb_t* b_parts = a_parts + 3 * w;
+        limb_t* pa = b_parts + 3 * w;  // Значения a в точках 1, -1, -2
+        limb_t* pb = pa + 3 * w;       // Значения b в точках 1, -1, -2
+        limb_t* r0 = pb + 3 * w;
+        limb_t* r1 = r0 + width;
+        limb_t* r_m1 = r1 + width;
+        limb_t* r_m2 = r_m1 + width;
+        limb_t* r_inf = r_m2 + width;
+        limb_t* r2 = r_inf + width;
+        limb_t* r3 = r2 + width;
+
+        // Части сомножителей, дополненные нулями до k + 1 блока
+        memset(a_parts, 0, 6 * w * sizeof(limb_t));
+        memcpy(a_parts, a, k * sizeof(limb_t));
+        memcpy(a_parts + w, a + k, k * sizeof(limb_t));
+        memcpy(a_parts + 2 * w, a + 2 * k, top * sizeof(limb_t));
+        memcpy(b_parts, b, k * sizeof(limb_t));
+        memcpy(b_parts + w, b + k, k * sizeof(limb_t));
+        memcpy(b_parts + 2 * w, b + 2 * k, top * sizeof(limb_t));
+
+        bool pa_m1_negative, pa_m2_negative, pb_m1_negative, pb_m2_negative;
+        toom3_evaluate(a_parts, k, pa, pa + w, pa_m1_negative, pa + 2 * w, pa_m2_negative);
+        if (a == b) {
+            pb = pa;
+            pb_m1_negative = pa_m1_negative;
+            pb_m2_negative = pa_m2_negative;
+        } else {
+            toom3_evaluate(b_parts, k, pb, pb + w, pb_m1_negative, pb + 2 * w, pb_m2_negative);
+        }
+
+        // Пять независимых произведений (знак произведения - произведение знаков)
+        memset(r0, 0, 5 * width * sizeof(limb_t));
+        const limb_t* left[5] = { a, pa, pa + w, pa + 2 * w, a + 2 * k };
+        const limb_t* right[5] = { b, pb, pb + w, pb + 2 * w, b + 2 * k };
+        const size_t sizes[5] = { k, w, w, w, top };
+        limb_t* products[5] = { r0, r1, r_m1, r_m2, r_inf };
+        run_tasks(5, n >= PARALLEL_THRESHOLD, [&](size_t i) {
+            mul_limbs(left[i], sizes[i], right[i], sizes[i], products[i]);
+        });
+        bool r_m1_negative = pa_m1_negative != pb_m1_negative;
+        bool r_m2_negative = pa_m2_negative != pb_m2_negative;
+
+        // Интерполяция (все деления точные)
+        bool r3_negative = add_signed(r3, r_m2, r_m2_negative, r1, true, width); // r3 = (r(-2) - r(1)) / 3
+        divexact_by3(r3, width);
+        bool r1_negative = add_signed(r1, r1, false, r_m1, !r_m1_negative, width); // r1 = (r(1) - r(-1)) / 2
+        shift_right_limbs(r1, r1, width, 1);
+        bool r2_negative = add_signed(r2, r_m1, r_m1_negative, r0, true, width);   // r2 = r(-1) - r(0)
+        r3_negative = add_signed(r3, r2, r2_negative, r3, !r3_negative, width);     // r3 = (r2 - r3) / 2 + 2*r(inf)
+        shift_right_limbs(r3, r3, width, 1);
+        r3_negative = add_signed(r3, r3, r3_negative, r_inf, false, width);
+        r3_negative = add_signed(r3, r3, r3_negative, r_inf, false, width);
+        r2_negative = add_signed(r2, r2, r2_negative, r1, r1_negative, width);       // r2 = r2 + r1 - r(inf)
+        r2_negative = add_signed(r2, r2, r2_negative, r_inf, true, width);
+        r1_negative = add_signed(r1, r1, r1_negative, r3, !r3_negative, width);      // r1 = r1 - r3
+        // Итоговые коэффициенты r1, r2, r3 неотрицательны
+
+        // Сборка результата: r0 + r1*B^k + r2*B^2k + r3*B^3k + r(inf)*B^4k
+        memcpy(r, r0, 2 * k * sizeof(limb_t));
+        memset(r + 2 * k, 0, (2 * n - 2 * k) * sizeof(limb_t));
+        memcpy(r + 4 * k, r_inf, 2 * top * sizeof(limb_t));
+        const limb_t* coefficients[3] = { r1, r2, r3 };
+        for (size_t i = 1; i <= 3; ++i) {
+            size_t available = 2 * n - i * k;
+            size_t count = width < available ? width : available; // Лишние старшие блоки заведомо нулевые
+            add_limbs(r + i * k, r + i * k, available, coefficients[i - 1], count);
+        }
+    }
+
+    // base^exponent по модулю mod (mod < 2^32)
+    static unsigned int pow_mod_u32(unsigned long long base, unsigned long long exponent, unsigned int mod) {
+        unsigned long long result = 1;
+        base %= mod;
+        while (exponent) {
+            if (exponent & 1) result = result * base % mod;
+            base = base * base % mod;
+            exponent >>= 1;
+        }
+        return (unsigned int)result;
+    }
+
+    // Прямое или обратное NTT на месте по модулю MOD; n - степень двойки.
+    // Модуль - параметр шаблона, чтобы компилятор заменил деление умножением на константу.
+    // roots - рабочий буфер на n / 2 элементов под степени корня n-й степени из единицы.
+    // При parallel бабочки каждого этапа делятся на куски между потоками WorkerPool
+    template <unsigned int MOD>
+    static void ntt_transform(unsigned int* a, size_t n, bool inverse, unsigned int* roots, bool parallel) {
+        // Перестановка с обращением битов индекса
+        for (size_t i = 1, j = 0; i < n; ++i) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) {
+                unsigned int t = a[i]; a[i] = a[j]; a[j] = t;
+            }
+        }
+
+        unsigned long long root = pow_mod_u32(NTT_PRIMITIVE_ROOT, (MOD - 1) / n, MOD);
+        if (inverse) root = pow_mod_u32(root, MOD - 2, MOD);
+        roots[0] = 1;
+        for (size_t i = 1; i < n / 2; ++i) roots[i] = (unsigned int)(roots[i - 1] * root % MOD);
+
+        // Бабочки Кули-Тьюки: на этапе длины len берется каждый (n / len)-й корень.
+        // Бабочки этапа независимы; бабочка t относится к блоку t / half и паре j = t % half в нем
+        for (size_t len = 2, half_bits = 0; len <= n; len <<= 1, ++half_bits) {
+            size_t half = len >> 1;
+            size_t step = n / len;
+            auto stage = [&](size_t begin, size_t end) {
+                for (size_t t = begin; t < end;) {
+                    size_t i = (t >> half_bits) * len;
+                    size_t j = t & (half - 1);
+                    size_t stop = end - t < half - j ? j + (end - t) : half;
+                    t += stop - j;
+                    for (; j < stop; ++j) {
+                        unsigned int u = a[i + j];
+                        unsigned int v = (unsigned int)((unsigned long long)a[i + j + half] * roots[j * step] % MOD);
+                        a[i + j] = (u + v >= MOD) ? u + v - MOD : u + v;
+                        a[i + j + half] = (u >= v) ? u - v : u + MOD - v;
+                    }
+                }
+            };
+            if (parallel) {
+                WorkerPool::instance().parallel_for(n / 2, NTT_PARALLEL_CHUNK, stage);
+            } else {
+                stage(0, n / 2);
+            }
+        }
+
+        if (inverse) {
+            unsigned long long n_inverse = pow_mod_u32(n, MOD - 2, MOD);
+            for (size_t i = 0; i < n; ++i) a[i] = (unsigned int)(a[i] * n_inverse % MOD);
+        }
+    }
+
+    // i-я 32-битная часть числа из блоков a (little endian)
+    static unsigned int limb_piece(const limb_t* a, size_t i) {
+        return (unsigned int)(a[i / PIECES_PER_LIMB] >> (PIECE_BITS * (i % PIECES_PER_LIMB)));
+    }
+
+    // Циклическая свертка a и b длины n по модулю MOD (результат в fa); an, bn - в 32-битных частях.
+    // При squaring массив b не используется и выполняется одно прямое преобразование
+    template <unsigned int MOD>
+    static void ntt_convolve(const limb_t* a, size_t an, const limb_t* b, size_t bn, size_t n, bool squaring,
+                             unsigned int* fa, unsigned int* fb, unsigned int* roots, bool parallel) {
+        for (size_t i = 0; i < an; ++i) fa[i] = limb_piece(a, i) % MOD;
+        memset(fa + an, 0, (n - an) * sizeof(unsigned int));
+        ntt_transform<MOD>(fa, n, false, roots, parallel);
+
+        if (squaring) {
+            for (size_t i = 0; i < n; ++i) fa[i] = (unsigned int)((unsigned long long)fa[i] * fa[i] % MOD);
+        } else {
+            for (size_t i = 0; i < bn; ++i) fb[i] = limb_piece(b, i) % MOD;
+            memset(fb + bn, 0, (n - bn) * sizeof(unsigned int));
+            ntt_transform<MOD>(fb, n, false, roots, parallel);
+            for (size_t i = 0; i < n; ++i) fa[i] = (unsigned int)((unsigned long long)fa[i] * fb[i] % MOD);
+        }
+
+        ntt_transform<MOD>(fa, n, true, roots, parallel);
+    }
+
+    // Умножение через NTT: свертка 32-битных частей блоков по трем простым модулям, затем восстановление
+    // коэффициентов по китайской теореме об остатках (алгоритм Гарнера) и распространение переносов.
+    // r содержит an + bn блоков. Если a и b - один и тот же массив, выполняется возведение в квадрат:
+    // для каждого модуля делается одно прямое преобразование вместо двух.
+    // Свертки по трем модулям и этапы преобразований идут в потоках WorkerPool (NTT_THRESHOLD больше PARALLEL_THRESHOLD)
+    static void mul_ntt(const limb_t* a, size_t an, const limb_t* b, size_t bn, limb_t* r) {
+        bool squaring = (a == b && an == bn);
+        size_t result_blocks = an + bn;
+        an *= PIECES_PER_LIMB;
+        bn *= PIECES_PER_LIMB;
+        size_t result_size = an + bn;
+        size_t n = 1;
+        while (n < result_size) n <<= 1;
+
+        // Параллельным сверткам нужны свои буферы fb и roots, последовательные используют один
+        bool parallel = WorkerPool::instance().threads() > 1;
+        size_t copies = parallel ? 3 : 1;
+        ScratchBuffer<unsigned int> residues(3 * n); // Свертка по каждому из модулей
+        ScratchBuffer<unsigned int> fb(squaring ? 1 : copies * n);
+        ScratchBuffer<unsigned int> roots(copies * (n / 2));
+
+        unsigned int* r1 = residues.data();
+        unsigned int* r2 = r1 + n;
+        unsigned int* r3 = r2 + n;
+        run_tasks(3, parallel, [&](size_t i) {
+            unsigned int* fb_i = fb.data() + (squaring ? 0 : (i % copies) * n);
+            unsigned int* roots_i = roots.data() + (i % copies) * (n / 2);
+            if (i == 0) ntt_convolve<NTT_PRIME_1>(a, an, b, bn, n, squaring, r1, fb_i, roots_i, parallel);
+            if (i == 1) ntt_convolve<NTT_PRIME_2>(a, an, b, bn, n, squaring, r2, fb_i, roots_i, parallel);
+            if (i == 2) ntt_convolve<NTT_PRIME_3>(a, an, b, bn, n, squaring, r3, fb_i, roots_i, parallel);
+        });
+
+        // Константы алгоритма Гарнера
+        const unsigned long long p1 = NTT_PRIME_1, p2 = NTT_PRIME_2, p3 = NTT_PRIME_3;
+        const unsigned long long p1_inv_mod_p2 = pow_mod_u32(p1, p2 - 2, (unsigned int)p2);
+        const unsigned long long p1_inv_mod_p3 = pow_mod_u32(p1, p3 - 2, (unsigned int)p3);
+        const unsigned long long p2_inv_mod_p3 = pow_mod_u32(p2, p3 - 2, (unsigned int)p3);
+        const unsigned __int128 p1p2 = (unsigned __int128)p1 * p2;
+
+        memset(r, 0, result_blocks * sizeof(limb_t));
+        unsigned __int128 carry = 0;
+        for (size_t i = 0; i < result_size; ++i) {
+            unsigned long long x1 = r1[i];
+            unsigned long long x2 = (r2[i] + p2 - x1 % p2) % p2 * p1_inv_mod_p2 % p2;
+            unsigned long long x3 = (r3[i] + p3 - x1 % p3) % p3 * p1_inv_mod_p3 % p3;
+            x3 = (x3 + p3 - x2 % p3) % p3 * p2_inv_mod_p3 % p3;
+            carry += x1 + (unsigned __int128)x2 * p1 + p1p2 * x3;
+            r[i / PIECES_PER_LIMB] |= (limb_t)(unsigned int)carry << (PIECE_BITS * (i % PIECES_PER_LIMB));
+            carry >>= PIECE_BITS;
+        }
+    }
+
+    // body(i) для i из [0, count): задачи WorkerPool при parallel, иначе по порядку в текущем потоке
+    template <typename Body>
+    static void run_tasks(size_t count, bool parallel, const Body& body) {
+        if (parallel) {
+            WorkerPool::instance().run_tasks(count, body);
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) body(i);
+    }
+
+    // Диспетчер умножения модулей: r = a * b, r содержит an + bn блоков.
+    // Выбирает "столбик", Карацубу, Toom-3 или NTT по размеру меньшего сомножителя;
+    // сильно несбалансированные сомножители умножаются по частям размера меньшего.
+    static void mul_limbs(const limb_t* a, size_t an, const limb_t* b, size_t bn, limb_t* r) {
+        if (an < bn) {
+            const limb_t* tp = a; a = b; b = tp;
+            size_t tn = an; an = bn; bn = tn;
+        }
+
+        if (bn < KARATSUBA_THRESHOLD) {
+            mul_schoolbook(a, an, b, bn, r);
+            return;
+        }
+
+        if (bn >= NTT_THRESHOLD && (an + bn) * PIECES_PER_LIMB <= NTT_MAX_LENGTH) {
+            mul_ntt(a, an, b, bn, r);
+            return;
+        }
+
+        if (an == bn) {
+            if (bn >= TOOM3_THRESHOLD) {
+                mul_toom3(a, b, bn, r);
+            } else {
+                ScratchBuffer<limb_t> workspace(karatsuba_scratch_size(bn));
+                mul_karatsuba(a, b, bn, r, workspace.data());
+            }
+            return;
+        }
+
+        // Несбалансированный случай: a режется на куски по bn блоков
+        memset(r, 0, (an + bn) * sizeof(limb_t));
+        size_t chunks = (an + bn - 1) / bn;
+        if (an * bn >= PARALLEL_THRESHOLD * PARALLEL_THRESHOLD && WorkerPool::instance().threads() > 1) {
+            // Произведения четных кусков не пересекаются и пишутся прямо в r, нечетных - в отдельный
+            // буфер, который прибавляется в конце: все куски независимы и считаются в потоках пула
+            ScratchBuffer<limb_t> odd(an + bn);
+            memset(odd.data(), 0, (an + bn) * sizeof(limb_t));
+            WorkerPool::instance().parallel_for(chunks, 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    size_t offset = i * bn;
+                    size_t chunk = (an - offset < bn) ? an - offset : bn;
+                    mul_limbs(a + offset, chunk, b, bn, (i % 2 ? odd.data() : r) + offset);
+                }
+            });
+            add_limbs(r, r, an + bn, odd.data(), an + bn);
+            return;
+        }
+        ScratchBuffer<limb_t> chunk_product(2 * bn);
+        for (size_t offset = 0; offset < an; offset += bn) {
+            size_t chunk = (an - offset < bn) ? an - offset : bn;
+            mul_limbs(a + offset, chunk, b, bn, chunk_product.data());
+            add_limbs(r + offset, r + offset, an + bn - offset, chunk_product.data(), chunk + bn);
+        }
+    }
+
+    // Возведение модуля в квадрат: r = a * a, r содержит 2n блоков.
+    // Диспетчер mul_limbs с одинаковыми сомножителями попадает в квадратные ветви ядер:
+    // симметричный "столбик", Карацуба и Toom-3 на квадратах, NTT с одним прямым преобразованием
+    static void sqr_limbs(const limb_t* a, size_t n, limb_t* r) {
+        mul_limbs(a, n, a, n, r);
+    }
+
+    // r = a * m (n блоков); возвращает старший блок произведения
+    static limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t m) {
+        return kernels().mul_1(r, a, n, m);
+    }
+
+    // r = r + a * m на месте (n блоков); возвращает перенос из старшего блока
+    static limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t m) {
+        return kernels().addmul_1(r, a, n, m);
+    }
+
+    // r = r - a * m на месте (n блоков); возвращает заем из старшего блока
+    static limb_t submul_1(limb_t* r, const limb_t* a, size_t n, limb_t m) {
+        return kernels().submul_1(r, a, n, m);
+    }
+
+    // --- Битовые операции ---
+
+    // Операции над блоками; code - номер ядра в таблице, zero_absorbs - результат с нулевым блоком всегда нулевой
+    struct BitAnd {
+        static const int code = BITWISE_AND;
+        static const bool zero_absorbs = true;
+        template <typename T> static T apply(T a, T b) { return a & b; }
+    };
+    struct BitOr {
+        static const int code = BITWISE_OR;
+        static const bool zero_absorbs = false;
+        template <typename T> static T apply(T a, T b) { return a | b; }
+    };
+    struct BitXor {
+        static const int code = BITWISE_XOR;
+        static const bool zero_absorbs = false;
+        template <typename T> static T apply(T a, T b) { return a ^ b; }
+    };
+
+    // r[i] = ((a[i] ^ a_mask) Op (b[i] ^ b_mask)) ^ r_mask для n блоков; r может совпадать с a, но не с b
+    template <typename Op>
+    static void bitwise_limbs(limb_t* r, const limb_t* a, limb_t a_mask, const limb_t* b, limb_t b_mask,
+                              limb_t r_mask, size_t n) {
+        kernels().bitwise[Op::code](r, a, a_mask, b, b_mask, r_mask, n);
+    }
+
+    // r = a << s (0 <= s < бит в блоке) для n >= 1 блоков; возвращает биты, вытесненные из старшего блока.
+    // r может совпадать с a или лежать выше него
+    static limb_t shift_left_limbs(limb_t* r, const limb_t* a, size_t n, int s) {
+        return kernels().shift_left_limbs(r, a, n, s);
+    }
+
+    // r = a >> s (0 <= s < бит в блоке) для n >= 1 блоков; r может совпадать с a или лежать ниже него
+    static void shift_right_limbs(limb_t* r, const limb_t* a, size_t n, int s) {
+        kernels().shift_right_limbs(r, a, n, s);
+    }
+
+    // *this = a << shift по модулю со знаком a; a может совпадать с *this.
+    // Сдвиг на целые блоки и на биты внутри блока выполняется одним проходом ядра
+    void shift_left_from(const BigInteger& a, size_t shift) {
+        size_t block_shift = shift / get_bits_per_limb();
+        int bit_shift = (int)(shift % get_bits_per_limb());
+        if (this == &a) ensure_big_format();
+        else digits_size = 0; // Прежние блоки результата не копируются при расширении
+        size_t n = MagnitudeView(a).size;
+        if (n == 0) {
+            *this = BigInteger(0);
+            return;
+        }
+        reserve(n + block_shift + 1);
+
+        MagnitudeView view(a); // После reserve: блоки *this могли переехать
+        digits[n + block_shift] = shift_left_limbs(digits + block_shift, view.limbs, n, bit_shift);
+        memset(digits, 0, block_shift * sizeof(limb_t));
+        is_negative = view.negative;
+        is_small_value = false;
+        digits_size = n + block_shift + 1;
+        normalize();
+        try_optimize();
+    }
+
+    // *this = a >> shift по модулю со знаком a; a может совпадать с *this
+    void shift_right_from(const BigInteger& a, size_t shift) {
+        size_t block_shift = shift / get_bits_per_limb();
+        int bit_shift = (int)(shift % get_bits_per_limb());
+        if (this == &a) ensure_big_format();
+        MagnitudeView view(a);
+        if (block_shift >= view.size) { // Сдвиг на всю длину числа
+            *this = BigInteger(0);
+            return;
+        }
+        size_t n = view.size - block_shift;
+        bool negative = view.negative;
+        if (this != &a) {
+            digits_size = 0;
+            reserve(n);
+        }
+        shift_right_limbs(digits, view.limbs + block_shift, n, bit_shift);
+        is_negative = negative;
+        is_small_value = false;
+        digits_size = n;
+        normalize();
+        try_optimize();
+    }
+
+    // *this = *this Op other на месте, в семантике дополнительного кода.
+    // Дополнительный код отрицательного числа с модулем m - это ~(m - 1): блоки m - 1 получаются
+    // по ходу прохода распространением заема (он идет дальше только через нулевые блоки m).
+    // Знак результата - Op от знаков; модуль отрицательного результата r - это ~r + 1, перенос тоже
+    // распространяется по ходу. Заемы и перенос затухают на первом ненулевом блоке, дальше каждый
+    // блок результата - ((x ^ a_mask) Op (y ^ b_mask)) ^ r_mask, и проход векторный
+    template <typename Op>
+    BigInteger& bitwise_assign(const BigInteger& other) {
+        if (is_small_value && other.is_small_value) { // У встроенного значения семантика та же
+            small_value = Op::apply(small_value, other.small_value);
+            return *this;
+        }
+        if (this == &other) { // Блоки other менялись бы по ходу прохода
+            BigInteger copy = other;
+            return bitwise_assign<Op>(copy);
+        }
+
+        ensure_big_format();
+        MagnitudeView b(other);
+        size_t an = digits_size, bn = b.size;
+        bool a_negative = is_negative, b_negative = b.negative;
+        limb_t a_mask = a_negative ? ~(limb_t)0 : 0; // Знаковое расширение дополнительного кода
+        limb_t b_mask = b_negative ? ~(limb_t)0 : 0;
+        limb_t r_mask = Op::apply(a_mask, b_mask);
+
+        // Длина результата: за пределами обоих чисел - только знаковое расширение
+        // (отрицательному результату может понадобиться еще один блок модуля)
+        size_t n = an > bn ? an : bn;
+        if (Op::zero_absorbs) {
+            if (!a_negative && an < n) n = an;
+            if (!b_negative && bn < n) n = bn;
+        }
+        if (r_mask) n++;
+
+        if (!a_negative && !b_negative) {
+            size_t common = an < bn ? an : bn;
+            reserve(n);
+            bitwise_limbs<Op>(digits, digits, 0, b.limbs, 0, 0, common);
+            // Хвост длинного числа (только у Or и Xor, там 0 Op y == y): у this он уже на месте
+            if (n > an) memcpy(digits + an, b.limbs + an, (n - an) * sizeof(limb_t));
+            digits_size = n;
+        } else {
+            if (n > an) resize(n);
+            limb_t a_borrow = a_negative, b_borrow = b_negative, r_carry = r_mask & 1;
+            size_t i = 0;
+            for (; i < n && (a_borrow | b_borrow | r_carry); ++i) {
+                limb_t x = i < an ? digits[i] : 0;
+                limb_t y = i < bn ? b.limbs[i] : 0;
+                limb_t r = Op::apply((x - a_borrow) ^ a_mask, (y - b_borrow) ^ b_mask);
+                a_borrow &= (limb_t)(x == 0);
+                b_borrow &= (limb_t)(y == 0);
+                r = (r ^ r_mask) + r_carry;
+                r_carry &= (limb_t)(r == 0);
+                digits[i] = r;
+            }
+            size_t common = an < bn ? an : bn;
+            if (common > n) common = n;
+            if (i < common) {
+                bitwise_limbs<Op>(digits + i, digits + i, a_mask, b.limbs + i, b_mask, r_mask, common - i);
+                i = common;
+            }
+            // Хвосты: за пределами числа его блоки - знаковое расширение
+            for (; i < n && i < an; ++i) digits[i] = Op::apply(digits[i] ^ a_mask, b_mask) ^ r_mask;
+            for (; i < n && i < bn; ++i) digits[i] = Op::apply(a_mask, b.limbs[i] ^ b_mask) ^ r_mask;
+            for (; i < n; ++i) digits[i] = Op::apply(a_mask, b_mask) ^ r_mask;
+            digits_size = n;
+            is_negative = r_mask != 0;
+        }
+        normalize();
+        try_optimize();
+        return *this;
+    }
+
+    // ~x = -x - 1 = -(x + 1) на месте: модуль увеличивается или уменьшается на 1, знак меняется
+    void complement() {
+        if (is_small_value) { // ~x встроенного значения всегда помещается в него же
+            small_value = ~small_value;
+            return;
+        }
+        if (is_negative) {
+            for (size_t i = 0; digits[i]-- == 0; ++i) {} // Модуль ненулевой: заем затухает
+            is_negative = false;
+        } else {
+            size_t i = 0;
+            while (i < digits_size && ++digits[i] == 0) ++i;
+            if (i == digits_size) {
+                resize(digits_size + 1);
+                digits[i] = 1;
+            }
+            is_negative = true;
+        }
+        normalize();
+        try_optimize();
+    }
+
+    // --- Пакетные операции ---
+
+    static size_t limb_count(const BigInteger& x) {
+        return x.is_small_value ? 1 : x.digits_size;
+    }
+
+    // Оценка работы деления "столбиком": (длина частного + 1) * длина делителя
+    static size_t division_work(const BigInteger& a, const BigInteger& m) {
+        size_t an = limb_count(a), mn = limb_count(m);
+        return (an >= mn ? an - mn + 1 : 1) * mn;
+    }
+
+    // body(begin, end) по кускам [0, count); work - оценка общей работы в операциях над блоками.
+    // Куски - в среднем по 8 на поток (балансировка неравных элементов), но не меньше BATCH_CHUNK_WORK
+    template <typename Body>
+    static void run_batch(size_t count, size_t work, const Body& body) {
+        if (work < BATCH_PARALLEL_WORK || count < 2) {
+            body(0, count);
+            return;
+        }
+        WorkerPool& pool = WorkerPool::instance();
+        size_t chunk = count / (pool.threads() * 8);
+        size_t min_chunk = (size_t)((double)BATCH_CHUNK_WORK * count / work) + 1;
+        if (chunk < min_chunk) chunk = min_chunk;
+        pool.parallel_for(count, chunk, body);
+    }
+
+    // --- НОД (алгоритм Лемера) ---
+
+    // r = x * a - y * b для неотрицательной разности (длины x и y произвольны);
+    // r содержит max(xn, yn) + 1 блоков
+    static void mul_sub_limbs(limb_t* r, const limb_t* x, size_t xn, limb_t a, const limb_t* y, size_t yn, limb_t b) {
+        size_t n = xn > yn ? xn : yn;
+        limb_t carry_a = 0, carry_b = 0, borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t pa = (dlimb_t)(i < xn ? x[i] : 0) * a + carry_a;
+            dlimb_t pb = (dlimb_t)(i < yn ? y[i] : 0) * b + carry_b;
+            carry_a = (limb_t)(pa >> get_bits_per_limb());
+            carry_b = (limb_t)(pb >> get_bits_per_limb());
+            dlimb_t diff = (dlimb_t)(limb_t)pa - (limb_t)pb - borrow;
+            r[i] = (limb_t)diff;
+            borrow = (limb_t)(diff >> get_bits_per_limb()) & 1;
+        }
+        r[n] = carry_a - carry_b - borrow;
+    }
+
+    // bits битов числа из n блоков, начиная с бита shift (за пределами числа - нули)
+    static limb_t extract_bits(const limb_t* d, size_t n, size_t shift) {
+        size_t index = shift / get_bits_per_limb();
+        int offset = (int)(shift % get_bits_per_limb());
+        if (index >= n) return 0;
+        limb_t result = d[index] >> offset;
+        if (offset != 0 && index + 1 < n) result |= d[index + 1] << (get_bits_per_limb() - offset);
+        return result;
+    }
+
+    // Матрица Лемера (Кнут, т.2, 4.5.2, алгоритм L) по старшим битам u >= v > 0 (u - не меньше двух блоков):
+    // пока частные для двух крайних приближений совпадают, они совпадают и с настоящими частными Евклида,
+    // и последовательность шагов сворачивается в (u, v) -> (A*u + B*v, C*u + D*v).
+    // B == 0 означает, что ни одного шага сделать нельзя и нужен полный шаг деления
+    static void lehmer_matrix(const BigInteger& u, const BigInteger& v, sdlimb_t& A, sdlimb_t& B,
+                              sdlimb_t& C, sdlimb_t& D) {
+        size_t shift = u.bit_length() - get_bits_per_limb();
+        sdlimb_t x = extract_bits(u.digits, u.digits_size, shift);
+        sdlimb_t y = extract_bits(v.digits, v.digits_size, shift);
+        A = 1; B = 0; C = 0; D = 1;
+        while (y + C != 0 && y + D != 0) {
+            sdlimb_t q = (x + A) / (y + C);
+            if (q != (x + B) / (y + D)) break;
+            sdlimb_t t = A - q * C; A = C; C = t;
+            t = B - q * D; B = D; D = t;
+            t = x - q * y; x = y; y = t;
+        }
+    }
+
+    // Модуль коэффициента матрицы Лемера (не превосходит 2^bits - 1)
+    static limb_t abs_limb(sdlimb_t value) { return (limb_t)(value < 0 ? -value : value); }
+
+    // Коэффициент матрицы Лемера как BigInteger
+    static BigInteger from_cofactor(sdlimb_t value) {
+        BigInteger result = from_limb(abs_limb(value));
+        if (value < 0) result.negate();
+        return result;
+    }
+
+    // (u, v) = (A*u + B*v, C*u + D*v) на уровне блоков. В каждой строке матрицы коэффициенты
+    // разных знаков (B != 0), результаты неотрицательны; t1, t2 - переиспользуемые буферы
+    static void lehmer_apply(BigInteger& u, BigInteger& v, sdlimb_t A, sdlimb_t B, sdlimb_t C, sdlimb_t D,
+                             BigInteger& t1, BigInteger& t2) {
+        u.ensure_big_format();
+        v.ensure_big_format();
+        size_t n = u.digits_size + 1;
+        t1.is_small_value = t2.is_small_value = false;
+        t1.is_negative = t2.is_negative = false;
+        t1.resize(n);
+        t2.resize(n);
+        if (B <= 0) mul_sub_limbs(t1.digits, u.digits, u.digits_size, abs_limb(A), v.digits, v.digits_size, abs_limb(B));
+        else mul_sub_limbs(t1.digits, v.digits, v.digits_size, abs_limb(B), u.digits, u.digits_size, abs_limb(A));
+        if (D <= 0) mul_sub_limbs(t2.digits, u.digits, u.digits_size, abs_limb(C), v.digits, v.digits_size, abs_limb(D));
+        else mul_sub_limbs(t2.digits, v.digits, v.digits_size, abs_limb(D), u.digits, u.digits_size, abs_limb(C));
+        t1.normalize();
+        t2.normalize();
+        u.swap(t1);
+        v.swap(t2);
+    }
+
+    // НОД чисел из одного блока (алгоритм Евклида на машинных словах)
+    static limb_t gcd_limb(limb_t a, limb_t b) {
+        while (b != 0) {
+            limb_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    // --- Перевод между системами счисления ---
+
+    // a = a * m + addend на месте (n блоков); возвращает перенос из старшего блока
+    static limb_t mul_add_1(limb_t* a, size_t n, limb_t m, limb_t addend) {
+        dlimb_t carry = addend;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t product = (dlimb_t)a[i] * m + carry;
+            a[i] = (limb_t)product;
+            carry = product >> get_bits_per_limb();
+        }
+        return (limb_t)carry;
+    }
+
+    // Сколько цифр основания base помещается в один блок; chunk_base = base^k
+    static size_t radix_chunk_digits(size_t base, limb_t& chunk_base) {
+        size_t k = 1;
+        dlimb_t power = base;
+        while (power * base <= (limb_t)-1) {
+            power *= base;
+            k++;
+        }
+        chunk_base = (limb_t)power;
+        return k;
+    }
+
+    // Кэш перевода текущего потока: степени оснований 2..36 и обратные величины степеней 10
+    struct RadixCache {
+        BigInteger powers[37][RADIX_MAX_LEVELS];
+        BigInteger reciprocals[RADIX_MAX_LEVELS];
+    };
+
+    static RadixCache& radix_cache() {
+        thread_local RadixCache cache;
+        return cache;
+    }
+
+    // Освобождение записей кэша перевода длиннее keep_limbs блоков (0 - всех)
+    static void trim_radix_cache(size_t keep_limbs) {
+        RadixCache& cache = radix_cache();
+        for (size_t level = 0; level < RADIX_MAX_LEVELS; ++level) {
+            for (size_t base = 0; base < 37; ++base) drop_if_longer(cache.powers[base][level], keep_limbs);
+            drop_if_longer(cache.reciprocals[level], keep_limbs);
+        }
+    }
+
+    // Обнуление числа с возвратом памяти в куче, если в нем больше keep_limbs блоков
+    static void drop_if_longer(BigInteger& x, size_t keep_limbs) {
+        if (x.is_small_value || x.digits_size <= keep_limbs) return;
+        x.release_storage();
+        x.assign_small(0);
+    }
+
+    // Степень chunk_base^(2^level) для основания base (2..36) из кэша текущего потока
+    static const BigInteger& radix_power(size_t base, size_t level) {
+        BigInteger& power = radix_cache().powers[base][level];
+        if (power.is_zero()) {
+            if (level == 0) {
+                limb_t chunk_base;
+                radix_chunk_digits(base, chunk_base);
+                power = from_limb(chunk_base);
+            } else {
+                power = radix_power(base, level - 1).square();
+            }
+        }
+        return power;
+    }
+
+    // Число из одного блока
+    static BigInteger from_limb(limb_t value) {
+        BigInteger result;
+        result.is_small_value = false;
+        result.resize(1);
+        result.digits[0] = value;
+        result.try_optimize();
+        return result;
+    }
+
+    // Неотрицательное число из n блоков (little endian, ведущие нули допускаются)
+    static BigInteger from_limbs(const limb_t* limbs, size_t n) {
+        if (n == 0) return BigInteger(0);
+        BigInteger result;
+        result.is_small_value = false;
+        result.resize(n);
+        memcpy(result.digits, limbs, n * sizeof(limb_t));
+        result.normalize();
+        result.try_optimize();
+        return result;
+    }
+
+    // floor(2^(2N) / d), где N - битовая длина d > 0. Метод Ньютона с удвоением точности:
+    // обратная величина старшей половины d уточняется одной итерацией x += x * (2^(2N) - d*x) / 2^(2N),
+    // после чего остается поправить результат на несколько единиц. Стоимость - O(M(N)).
+    static BigInteger newton_reciprocal(const BigInteger& d) {
+        size_t n = d.bit_length();
+        BigInteger numerator = BigInteger(1) << (int)(2 * n);
+        if (n <= RECIPROCAL_BASECASE_BITS) {
+            return numerator / d;
+        }
+
+        size_t k = n / 2 + 1;
+        BigInteger x = newton_reciprocal(d >> (int)(n - k)) << (int)(n - k);
+        BigInteger error = numerator;
+        error.submul(d, x);
+        x += (x * error) >> (int)(2 * n);
+
+        // Поправка до точного значения: 0 <= 2^(2N) - d*x < d
+        BigInteger rem = numerator;
+        rem.submul(d, x);
+        while (rem < BigInteger(0)) {
+            x -= BigInteger(1);
+            rem += d;
+        }
+        while (rem >= d) {
+            x += BigInteger(1);
+            rem -= d;
+        }
+        return x;
+    }
+
+    // Деление Барретта на d с заранее вычисленной reciprocal = floor(2^(2N) / d) (N - битовая длина d).
+    // Требует 0 <= x < 2^(2N); стоит два умножения вместо длинного деления
+    static void barrett_divmod(const BigInteger& x, const BigInteger& d, const BigInteger& reciprocal, size_t d_bits,
+                               BigInteger& quotient, BigInteger& remainder) {
+        quotient = (x * reciprocal) >> (int)(2 * d_bits);
+        remainder = x;
+        remainder.submul(quotient, d);
+        while (remainder >= d) {
+            remainder -= d;
+            quotient += BigInteger(1);
+        }
+    }
+
+    // Обратная величина для степени radix_power(10, level) из кэша текущего потока
+    static const BigInteger& decimal_reciprocal(size_t level) {
+        BigInteger& reciprocal = radix_cache().reciprocals[level];
+        if (reciprocal.is_zero()) {
+            reciprocal = newton_reciprocal(radix_power(10, level));
+        }
+        return reciprocal;
+    }
+
+    // Число из блоков-"цифр" по основанию chunk_base (little endian).
+    // Старшая половина умножается на кэшированную степень и складывается с младшей: O(M(n) log n)
+    static BigInteger parse_chunks(const limb_t* chunks, size_t count, size_t base, limb_t chunk_base) {
+        if (count <= RADIX_BASECASE) {
+            // Схема Горнера по блокам
+            BigInteger result;
+            result.is_small_value = false;
+            result.resize(count + 1);
+            limb_t* r = result.digits;
+            size_t used = 0;
+            for (size_t i = count; i-- > 0;) {
+                limb_t carry = mul_add_1(r, used, chunk_base, chunks[i]);
+                if (carry) r[used++] = carry;
+            }
+            result.normalize();
+            result.try_optimize();
+            return result;
+        }
+
+        // Младшая часть - ровно 2^level блоков, где 2^level < count <= 2^(level + 1)
+        size_t level = 0;
+        while (((size_t)2 << level) < count) level++;
+        size_t low_count = (size_t)1 << level;
+
+        BigInteger result = parse_chunks(chunks + low_count, count - low_count, base, chunk_base);
+        result *= radix_power(base, level);
+        result += parse_chunks(chunks, low_count, base, chunk_base);
+        return result;
+    }
+
+    // Число по основанию 2^bits_per_digit: цифры упаковываются в блоки напрямую за O(n)
+    static BigInteger parse_power_of_two(const unsigned char* values, size_t count, int bits_per_digit) {
+        BigInteger result;
+        result.is_small_value = false;
+        result.resize((count * bits_per_digit) / get_bits_per_limb() + 1);
+        limb_t* r = result.digits;
+        size_t bit_position = 0;
+        for (size_t i = count; i-- > 0; bit_position += bits_per_digit) {
+            size_t index = bit_position / get_bits_per_limb();
+            int offset = (int)(bit_position % get_bits_per_limb());
+            r[index] |= (limb_t)values[i] << offset;
+            if (offset + bits_per_digit > get_bits_per_limb()) {
+                r[index + 1] |= (limb_t)values[i] >> (get_bits_per_limb() - offset);
+            }
+        }
+        result.normalize();
+        result.try_optimize();
+        return result;
+    }
+
+    // Потоковый вывод неотрицательного числа в десятичном виде, дополненного нулями слева до pad цифр.
+    // Число делится на степень 10^(k * 2^level) (10^k - наибольшая степень, помещающаяся в блок) примерно пополам (деление Барретта по кэшированной
+    // обратной величине), старшая часть выводится раньше младшей - цифры уходят в поток по мере получения
+    static void write_decimal(std::ostream& os, const BigInteger& x, size_t pad) {
+        limb_t chunk_base;
+        size_t chunk_digits = radix_chunk_digits(10, chunk_base);
+
+        if (x.is_small_value || x.digits_size <= RADIX_BASECASE) {
+            // Базовый случай: деление на 10^k с остатком, по k цифр за проход
+            BigInteger temp = x;
+            temp.ensure_big_format();
+            limb_t* t = temp.digits;
+            size_t n = temp.digits_size;
+            ScratchBuffer<char> buffer(n * (chunk_digits + 1) + 1);
+            LimbDivisor divisor(chunk_base);
+            size_t idx = 0;
+            while (n > 0) {
+                limb_t chunk = divmod_1(t, t, n, divisor);
+                while (n > 0 && t[n - 1] == 0) n--;
+                // Внутренние блоки - ровно k цифр, у старшего ведущие нули не пишутся
+                for (size_t i = 0; i < chunk_digits && (n > 0 || chunk != 0); ++i) {
+                    buffer[idx++] = (char)('0' + chunk % 10);
+                    chunk /= 10;
+                }
+            }
+            if (idx == 0 && pad == 0) buffer[idx++] = '0';
+
+            for (size_t i = idx; i < pad; ++i) os.put('0');
+            for (size_t i = idx; i > 0; --i) os.put(buffer[i - 1]);
+            return;
+        }
+
+        // Наименьший уровень, для которого x < 2^(2N) (N - битовая длина степени)
+        size_t bits = x.bit_length();
+        size_t level = 0;
+        while (2 * radix_power(10, level).bit_length() < bits) level++;
+
+        const BigInteger& power = radix_power(10, level);
+        BigInteger quotient, remainder;
+        barrett_divmod(x, power, decimal_reciprocal(level), power.bit_length(), quotient, remainder);
+
+        size_t low_digits = chunk_digits << level;
+        if (quotient.is_zero()) {
+            write_decimal(os, remainder, pad);
+            return;
+        }
+        write_decimal(os, quotient, pad > low_digits ? pad - low_digits : 0);
+        write_decimal(os, remainder, low_digits);
+    }
+
+    // --- Корни (вспомогательные функции) ---
+
+    // Шаг Ньютона для корня степени n: ((n - 1) * r + x / r^(n - 1)) / n при r > 0.
+    // По неравенству о средних результат не меньше floor(x^(1/n)) при любом r > 0
+    static BigInteger root_newton_step(const BigInteger& x, const BigInteger& r, unsigned int n) {
+        BigInteger t = x / r.pow(n - 1);
+        t.addmul(r, BigInteger((long long)n - 1));
+        return t / n;
+    }
+
+    // floor(x^(1/n)) для x > 0, n >= 2. Корень из не более чем 62 бит начинается с оценки
+    // в double и уточняется шагами Ньютона сверху. Длиннее - удвоением точности: корень из x без
+    // n * s младших битов дает старшие биты ответа (рекурсивно), (top + 1) * 2^s не меньше корня,
+    // и один шаг Ньютона удваивает число верных битов. s выбран так, чтобы ошибка после шага
+    // была меньше единицы, поэтому работа - одно деление и одно-два возведения в степень полной
+    // длины плюс вдвое меньшие на каждом уровне рекурсии
+    static BigInteger root_floor(const BigInteger& x, unsigned int n) {
+        size_t bits = x.bit_length();
+        if (n >= bits) return BigInteger(1); // 2^(bits - 1) <= x < 2^bits, корень меньше 2
+        size_t root_bits = (bits + n - 1) / n; // Корень меньше 2^root_bits
+
+        if (root_bits <= 62) {
+            size_t low = bits > 64 ? bits - 64 : 0; // Старшие 64 бита x дают оценку с точностью double
+            double log2_x = std::log2((double)x.magnitude_bits(low)) + (double)low;
+            double estimate = std::exp2(log2_x / n);
+            BigInteger r((long long)(estimate < 1.0 ? 1.0 : estimate > 0x1p62 ? 0x1p62 : estimate));
+            r = root_newton_step(x, r, n); // Теперь r не меньше корня, дальше последовательность убывает
+            while (true) {
+                BigInteger next = root_newton_step(x, r, n);
+                if (next >= r) return r;
+                r = std::move(next);
+            }
+        }
+
+        size_t guard = 8 + (size_t)(32 - __builtin_clz(n)); // Запас битов: ошибка шага ~ n * 2^(2s - root_bits)
+        size_t s = (root_bits - guard) / 2;
+        BigInteger top = root_floor(x >> (int)(n * s), n);
+        BigInteger r = root_newton_step(x, (top + BigInteger(1)) << (int)s, n);
+        while (r.pow(n) > x) --r; // Шаг дал значение не меньше корня и с ошибкой меньше единицы
+        return r;
+    }
+
+    // Количество младших нулевых битов модуля (x != 0)
+    size_t trailing_zero_bits() const {
+        MagnitudeView view(*this);
+        size_t zero_limbs = 0;
+        while (view.limbs[zero_limbs] == 0) ++zero_limbs;
+        return zero_limbs * get_bits_per_limb() + count_trailing_zeros(view.limbs[zero_limbs]);
+    }
+
+    // Является ли x (|x| >= 2) p-й степенью (p простое); если да, root = x^(1/p).
+    // Дешевые проверки до вычисления корня: показатель двойки в r^p делится на p;
+    // корень до 40 бит точно восстанавливается округлением оценки в double (ее ошибка порядка
+    // r * log2(r) * 2^-53), и r^p сверяется с x по младшим 64 битам; для длинного корня -
+    // проверка вычетов (power_residue_check)
+    bool exact_root(unsigned int p, BigInteger& root) const {
+        if (trailing_zero_bits() % p != 0) return false;
+        size_t bits = bit_length();
+        if ((bits + p - 1) / p <= 40) {
+            size_t low = bits > 64 ? bits - 64 : 0;
+            double log2_x = std::log2((double)magnitude_bits(low)) + (double)low;
+            unsigned long long r = (unsigned long long)std::llround(std::exp2(log2_x / p));
+            unsigned long long power = 1, base = r; // r^p mod 2^64
+            for (unsigned int e = p; e != 0; e >>= 1) {
+                if (e & 1) power *= base;
+                base *= base;
+            }
+            if (power != magnitude_bits(0)) return false;
+            root = BigInteger((long long)r);
+            if (sign() < 0) root.negate();
+        } else {
+            if (!power_residue_check(p)) return false;
+            root = iroot(p);
+        }
+        return root.pow(p) == *this;
+    }
+
+    // Может ли x быть p-й степенью (p простое): по модулю простого q = k * p + 1 вычет p-й степени
+    // в степени (q - 1) / p равен 0 или 1. Два таких модуля отсекают почти все не-степени
+    bool power_residue_check(unsigned int p) const {
+        int checked = 0;
+        for (unsigned long long q = p + 1; checked < 2 && q < ((unsigned long long)p << 8); q += p) {
+            bool prime = true;
+            for (unsigned long long d = 2; prime && d * d <= q; ++d) prime = q % d != 0;
+            if (!prime) continue;
+            unsigned long long residue = (*this % q).magnitude_bits(0);
+            if (residue == 0) continue; // Делимость на q ничего не говорит
+            unsigned long long power = 1, base = residue;
+            for (unsigned long long e = (q - 1) / p; e != 0; e >>= 1) {
+                if (e & 1) power = (unsigned long long)((unsigned __int128)power * base % q);
+                base = (unsigned long long)((unsigned __int128)base * base % q);
+            }
+            if (power != 1) return false;
+            ++checked;
+        }
+        return true;
+    }
+
+    // --- Простые числа (вспомогательные функции) ---
+
+    // Простые числа меньше PRIME_SIEVE_LIMIT (решето Эратосфена, строится один раз)
+    static const std::vector<unsigned int>& small_primes() {
+        static const std::vector<unsigned int> primes = []() {
+            std::vector<bool> composite(PRIME_SIEVE_LIMIT, false);
+            std::vector<unsigned int> result;
+            for (unsigned int i = 2; i < PRIME_SIEVE_LIMIT; ++i) {
+                if (composite[i]) continue;
+                result.push_back(i);
+                for (unsigned long long m = (unsigned long long)i * i; m < PRIME_SIEVE_LIMIT; m += i) composite[m] = true;
+            }
+            return result;
+        }();
+        return primes;
+    }
+
+    // Количество простых чисел меньше limit (limit <= PRIME_SIEVE_LIMIT)
+    static size_t small_prime_count(unsigned int limit) {
+        const std::vector<unsigned int>& primes = small_primes();
+        return std::lower_bound(primes.begin(), primes.end(), limit) - primes.begin();
+    }
+
+    // Остатки модуля x от деления на первые count простых чисел. Простые объединяются в
+    // произведения, помещающиеся в блок: один проход divmod_1 по числу на группу, дальше - остатки
+    // одного блока
+    void small_prime_residues(size_t count, unsigned int* out) const {
+        const std::vector<unsigned int>& primes = small_primes();
+        MagnitudeView view(*this);
+        size_t i = 0;
+        while (i < count) {
+            dlimb_t product = primes[i];
+            size_t end = i + 1;
+            while (end < count && product * primes[end] <= (limb_t)-1) product *= primes[end++];
+            limb_t rem = divmod_1(0, view.limbs, view.size, LimbDivisor((limb_t)product));
+            for (; i < end; ++i) out[i] = (unsigned int)(rem % primes[i]);
+        }
+    }
+
+    // a * b mod m для 64-битных чисел
+    static unsigned long long mulmod_u64(unsigned long long a, unsigned long long b, unsigned long long m) {
+        return (unsigned long long)((unsigned __int128)a * b % m);
+    }
+
+    // Проверка простоты числа из 64 бит: пробное деление на простые до 37 и тест Миллера - Рабина
+    // по семи основаниям Синклера (точен для всех n < 2^64)
+    static bool is_prime_u64(unsigned long long n) {
+        static const unsigned int primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+        static const unsigned long long bases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+        if (n < 2) return false;
+        for (size_t i = 0; i < sizeof(primes) / sizeof(primes[0]); ++i) {
+            if (n % primes[i] == 0) return n == primes[i];
+        }
+        if (n < 41 * 41) return true;
+
+        int s = __builtin_ctzll(n - 1);
+        unsigned long long d = (n - 1) >> s;
+        for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); ++i) {
+            unsigned long long x = 1, base = bases[i] % n;
+            if (base == 0) continue; // Основание кратно n - раунд ничего не говорит
+            for (unsigned long long e = d; e != 0; e >>= 1) {
+                if (e & 1) x = mulmod_u64(x, base, n);
+                base = mulmod_u64(base, base, n);
+            }
+            if (x == 1 || x == n - 1) continue;
+            int r = 1;
+            for (; r < s; ++r) {
+                x = mulmod_u64(x, x, n);
+                if (x == n - 1) break;
+            }
+            if (r == s) return false;
+        }
+        return true;
+    }
+
+    // Символ Якоби (a / n) для нечетного n > 0 (бинарный алгоритм с законом взаимности)
+    static int jacobi_u64(unsigned long long a, unsigned long long n) {
+        int result = 1;
+        a %= n;
+        while (a != 0) {
+            while ((a & 1) == 0) {
+                a >>= 1;
+                if ((n & 7) == 3 || (n & 7) == 5) result = -result;
+            }
+            std::swap(a, n);
+            if ((a & 3) == 3 && (n & 3) == 3) result = -result;
+            a %= n;
+        }
+        return n == 1 ? result : 0;
+    }
+
+    // Символ Якоби (d / x) для нечетного x > 0 и малого d > 0: двойки d дают знак по x mod 8,
+    // после переворота по закону взаимности остается (x mod d' / d')
+    int jacobi_small(unsigned long long d) const {
+        int result = 1;
+        unsigned long long low = magnitude_bits(0);
+        while ((d & 1) == 0) {
+            d >>= 1;
+            if ((low & 7) == 3 || (low & 7) == 5) result = -result;
+        }
+        if ((d & 3) == 3 && (low & 3) == 3) result = -result;
+        MagnitudeView view(*this);
+        return result * jacobi_u64(divmod_1(0, view.limbs, view.size, LimbDivisor((limb_t)d)), d);
+    }
+
+    // Тест Baillie - PSW для нечетного x > 2^64 без малых делителей: сильный тест по основанию 2
+    // и сильный тест Лукаса с параметром p - первым из 3, 4, 5, ..., для которого
+    // (p^2 - 4 / x) = -1 (у полного квадрата такого p нет - он отсеивается после нескольких
+    // неудачных p). Составных чисел, проходящих оба теста, не известно. Дальше - extra_rounds
+    // раундов Миллера - Рабина по основаниям 3, 5, 7, ...
+    bool probable_prime_test(int extra_rounds) const {
+        ModContext context(*this);
+        if (!context.strong_probable_prime(BigInteger(2))) return false;
+
+        unsigned int p = 3;
+        for (;; ++p) {
+            int j = jacobi_small((unsigned long long)p * p - 4);
+            if (j == -1) break;
+            if (j == 0) return false; // Общий делитель с p^2 - 4 < x
+            if (p == 20 && isqrt().square() == *this) return false;
+        }
+        if (!context.lucas_probable_prime(p)) return false;
+
+        const std::vector<unsigned int>& primes = small_primes();
+        for (int i = 0; i < extra_rounds && i + 1 < (int)primes.size(); ++i) {
+            if (!context.strong_probable_prime(BigInteger((long long)primes[i + 1]))) return false;
+        }
+        return true;
+    }
+
+    // Смена знака на месте (в том числе для SMALL_INT_MIN в формате small_value)
+    void negate() {
+        if (is_small_value) {
+            if (small_value != SMALL_INT_MIN) {
+                small_value = -small_value;
+                return;
+            }
+            ensure_big_format(); // -SMALL_INT_MIN не помещается в small_value
+        }
+        is_negative = !is_negative;
+        normalize();
+    }
+
+public:
+    // --- Конструкторы ---
+    BasicBigInteger()
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS),
+          is_negative(false), is_small_value(true), small_value(0) {}
+
+    BasicBigInteger(int value)
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS),
+          is_negative(false), is_small_value(true), small_value(value) {}
+
+    BasicBigInteger(long long value)
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS),
+          is_negative(false), is_small_value(true), small_value(value) {}
+
+    // Конструктор от массива int (little endian, каждый int - 32 бита модуля)
+    BasicBigInteger(const int* digit_array, size_t array_size)
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS),
+          is_negative(false), is_small_value(false), small_value(0) {
+        if (array_size == 0) {
+            digits_size = 1;
+            digits[0] = 0;
+        } else {
+            // Части упаковываются в блоки по PIECES_PER_LIMB штук
+            resize((array_size + PIECES_PER_LIMB - 1) / PIECES_PER_LIMB);
+            for (size_t i = 0; i < array_size; ++i) {
+                digits[i / PIECES_PER_LIMB] |= (limb_t)(unsigned int)digit_array[i] << (PIECE_BITS * (i % PIECES_PER_LIMB));
+            }
+        }
+        normalize();
+        try_optimize();
+    }
+
+    // Конструктор от строки (big endian) с указанием основания (от 2 до 36).
+    // Недопустимые символы и цифры, не меньшие основания, пропускаются.
+    // Цифры группируются в блоки по k цифр (base^k помещается в блок), блоки собираются
+    // "разделяй и властвуй"; для оснований - степеней двойки биты упаковываются напрямую
+    BasicBigInteger(const char* str, size_t base = 10)
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS),
+          is_negative(false), is_small_value(true), small_value(0) {
+        if (!str || base < 2 || base > 36) return;
+
+        size_t len = strlen(str);
+        size_t start = 0;
+
+        if (str[0] == '-') {
+            start = 1;
+        } else if (str[0] == '+') {
+            start = 1;
+        }
+
+        // Значения цифр (big endian)
+        ScratchBuffer<unsigned char> values(len);
+        size_t count = 0;
+        for (size_t i = start; i < len; i++) {
+            char c = str[i];
+            int digit_val;
+
+            if (c >= '0' && c <= '9') {
+                digit_val = c - '0';
+            } else if (c >= 'A' && c <= 'Z') {
+                digit_val = c - 'A' + 10;
+            } else if (c >= 'a' && c <= 'z') {
+                digit_val = c - 'a' + 10;
+            } else {
+                continue; // Пропускаем недопустимые символы
+            }
+
+            if ((size_t)digit_val >= base) continue; // Пропускаем цифры, превышающие основание
+            values[count++] = (unsigned char)digit_val;
+        }
+
+        if ((base & (base - 1)) == 0) {
+            int bits_per_digit = 0;
+            while (((size_t)1 << bits_per_digit) < base) bits_per_digit++;
+            *this = parse_power_of_two(values.data(), count, bits_per_digit);
+        } else {
+            // Блок i (little endian) - цифры [count - (i + 1)k, count - ik)
+            limb_t chunk_base;
+            size_t k = radix_chunk_digits(base, chunk_base);
+            size_t chunk_count = (count + k - 1) / k;
+            ScratchBuffer<limb_t> chunks(chunk_count);
+            for (size_t i = 0; i < chunk_count; ++i) {
+                size_t end = count - i * k;
+                size_t begin = end > k ? end - k : 0;
+                limb_t chunk = 0;
+                for (size_t j = begin; j < end; ++j) chunk = chunk * (limb_t)base + values[j];
+                chunks[i] = chunk;
+            }
+            *this = parse_chunks(chunks.data(), chunk_count, base, chunk_base);
+            trim_radix_cache(RADIX_CACHE_KEEP_LIMBS);
+        }
+
+        // Цифры накапливались как модуль; знак применяем в конце ("-0" остается нулем)
+        if (str[0] == '-') negate();
+    }
+
+    BasicBigInteger(const std::string& str, size_t base = 10) : BasicBigInteger(str.c_str(), base) {}
+
+    // Копирующий конструктор
+    BasicBigInteger(const BigInteger& other)
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS) {
+        copy_from(other);
+    }
+
+    // Перемещающий конструктор (память в куче передается без копирования)
+    BasicBigInteger(BigInteger&& other) noexcept
+        : digits(inline_digits), digits_size(0), digits_capacity(INLINE_BIGINT_DIGITS) {
+        move_from(other);
+    }
+
+    // Оператор присваивания
+    BigInteger& operator=(const BigInteger& other) {
+        if (this == &other) return *this; // Самоприсваивание
+        copy_from(other);
+        return *this;
+    }
+
+    // Перемещающий оператор присваивания
+    BigInteger& operator=(BigInteger&& other) noexcept {
+        if (this == &other) return *this;
+        move_from(other);
+        return *this;
+    }
+
+    // Обмен значениями без копирования памяти в куче
+    void swap(BigInteger& other) noexcept {
+        BigInteger temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    // --- Деструктор ---
+    ~BasicBigInteger() {
+        release_storage();
+    }
+
+    // --- Операторы сравнения ---
+    // Работают напрямую с блоками операндов, без временных копий
+    bool operator==(const BigInteger& other) const { return equals(other); }
+    bool operator!=(const BigInteger& other) const { return !equals(other); }
+    bool operator<(const BigInteger& other) const { return compare(other) < 0; }
+    bool operator<=(const BigInteger& other) const { return compare(other) <= 0; }
+    bool operator>(const BigInteger& other) const { return compare(other) > 0; }
+    bool operator>=(const BigInteger& other) const { return compare(other) >= 0; }
+
+    // Проверка на ноль без создания временного BigInteger(0)
+    bool is_zero() const {
+        if (is_small_value) return small_value == 0;
+        return digits_size == 0 || (digits_size == 1 && digits[0] == 0);
+    }
+
+    // Знак числа: -1, 0 или 1
+    int sign() const {
+        if (is_small_value) return (small_value > 0) - (small_value < 0);
+        return is_zero() ? 0 : is_negative ? -1 : 1;
+    }
+
+    // --- Арифметические операторы ---
+    // Перегрузки для временных операндов (&&) накапливают результат в буфере временного числа:
+    // цепочка a * b + c * d - e создает только сами произведения, без копий на каждом шаге
+
+    BigInteger& operator+=(const BigInteger& other) {
+        return add_signed(other, false);
+    }
+
+    BigInteger operator+(const BigInteger& other) const & {
+        BigInteger result = *this;
+        result += other;
+        return result;
+    }
+
+    BigInteger operator+(const BigInteger& other) && {
+        *this += other;
+        return std::move(*this);
+    }
+
+    BigInteger operator+(BigInteger&& other) const & {
+        other += *this;
+        return std::move(other);
+    }
+
+    BigInteger operator+(BigInteger&& other) && {
+        *this += other;
+        return std::move(*this);
+    }
+
+    BigInteger& operator-=(const BigInteger& other) {
+        return add_signed(other, true); // Вычитание = сложение с инвертированным знаком
+    }
+
+    BigInteger operator-(const BigInteger& other) const & {
+        BigInteger result = *this;
+        result -= other;
+        return result;
+    }
+
+    BigInteger operator-(const BigInteger& other) && {
+        *this -= other;
+        return std::move(*this);
+    }
+
+    BigInteger operator-(BigInteger&& other) const & { // a - t = -(t - a)
+        other -= *this;
+        other.negate();
+        return std::move(other);
+    }
+
+    BigInteger operator-(BigInteger&& other) && {
+        *this -= other;
+        return std::move(*this);
+    }
+
+    // Умножение со сложением: *this += b * c и *this -= b * c за один проход, без временного
+    // произведения (для короткого сомножителя - прямо по блокам числа)
+    BigInteger& addmul(const BigInteger& b, const BigInteger& c) {
+        return add_product(b, c, false);
+    }
+
+    BigInteger& submul(const BigInteger& b, const BigInteger& c) {
+        return add_product(b, c, true);
+    }
+
+    BigInteger& operator*=(const BigInteger& other) {
+        if (this == &other) { // x *= x - возведение в квадрат
+            *this = square();
+            return *this;
+        }
+
+        if (is_small_value && other.is_small_value) {
+            small_int_t result;
+            if (!__builtin_mul_overflow(small_value, other.small_value, &result)) {
+                small_value = result;
+                return *this;
+            }
+        }
+
+        // Произведение строится в отдельном буфере, затем забирается без копирования
+        BigInteger product_value;
+        multiply_into(*this, other, product_value);
+        *this = std::move(product_value);
+        return *this;
+    }
+
+    // Произведение сразу строится в результате, без копии левого операнда
+    BigInteger operator*(const BigInteger& other) const {
+        BigInteger result;
+        multiply_into(*this, other, result);
+        return result;
+    }
+
+    // Деление с остатком за один проход: a = quotient * b + remainder.
+    // Частное округляется к нулю, знак остатка совпадает со знаком делимого (как у / и %).
+    // При делении на ноль оба результата равны 0.
+    static void divmod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder) {
+        // Обработка small_value оптимизации (SMALL_INT_MIN / -1 не помещается в small_value)
+        if (a.is_small_value && b.is_small_value && b.small_value != 0 &&
+            !(a.small_value == SMALL_INT_MIN && b.small_value == -1)) {
+            small_int_t q = a.small_value / b.small_value;
+            small_int_t r = a.small_value % b.small_value;
+            quotient.assign_small(q);
+            remainder.assign_small(r);
+            return;
+        }
+
+        // Преобразование в big_format для обеих сторон
+        BigInteger dividend = a;
+        dividend.ensure_big_format();
+        BigInteger divisor = b;
+        divisor.ensure_big_format();
+
+        bool quotient_negative = (dividend.is_negative != divisor.is_negative);
+        bool remainder_negative = dividend.is_negative;
+
+        // Внутреннее деление работает с абсолютными значениями
+        dividend.is_negative = false;
+        divisor.is_negative = false;
+
+        BigInteger q;
+        BigInteger r;
+        dividend.divide_internal(divisor, q, r);
+
+        // Восстанавливаем знаки (у нуля знак всегда положительный)
+        if (quotient_negative) q.negate();
+        if (remainder_negative) r.negate();
+        quotient = std::move(q);
+        remainder = std::move(r);
+    }
+
+    // Наибольший общий делитель (неотрицательный; gcd(0, 0) = 0).
+    // Алгоритм Лемера: несколько шагов Евклида выполняются по старшим битам на машинных словах
+    // и применяются к числам одним проходом mul_sub_limbs; для сильно разных по длине чисел
+    // (когда шаг Лемера невозможен) делается обычный шаг деления
+    static BigInteger gcd(const BigInteger& a, const BigInteger& b) {
+        BigInteger u = a, v = b;
+        if (u < BigInteger(0)) u.negate();
+        if (v < BigInteger(0)) v.negate();
+        if (u < v) u.swap(v);
+
+        BigInteger t1, t2;
+        while (!v.is_zero()) {
+            MagnitudeView u_view(u);
+            if (u_view.size <= 1) {
+                MagnitudeView v_view(v);
+                return from_limb(gcd_limb(u_view.limbs[0], v_view.limbs[0]));
+            }
+
+            sdlimb_t A, B, C, D;
+            u.ensure_big_format();
+            v.ensure_big_format();
+            lehmer_matrix(u, v, A, B, C, D);
+            if (B == 0) {
+                BigInteger quotient, remainder;
+                divmod(u, v, quotient, remainder);
+                u.swap(v);
+                v.swap(remainder);
+            } else {
+                lehmer_apply(u, v, A, B, C, D, t1, t2);
+            }
+            u.try_optimize();
+            v.try_optimize();
+        }
+        return u;
+    }
+
+    // Расширенный алгоритм Евклида: возвращает g = gcd(a, b) и коэффициенты x, y, для которых
+    // a*x + b*y = g. Отслеживается только коэффициент при a (матрицы Лемера применяются и к нему),
+    // коэффициент при b восстанавливается в конце точным делением
+    static BigInteger xgcd(const BigInteger& a, const BigInteger& b, BigInteger& x, BigInteger& y) {
+        if (a.compare_abs(b) < 0) return xgcd(b, a, y, x);
+        if (b.is_zero()) {
+            x = BigInteger(a < BigInteger(0) ? -1 : 1);
+            y = BigInteger(0);
+            if (a.is_zero()) x = BigInteger(0);
+            return a < BigInteger(0) ? -a : a;
+        }
+
+        // Инвариант: u = su * |a| (mod |b|), v = sv * |a| (mod |b|)
+        BigInteger u = a, v = b;
+        if (u < BigInteger(0)) u.negate();
+        if (v < BigInteger(0)) v.negate();
+        BigInteger su(1), sv(0);
+
+        BigInteger t1, t2;
+        while (!v.is_zero()) {
+            sdlimb_t A = 1, B = 0, C = 0, D = 1;
+            if (MagnitudeView(u).size > 1) {
+                u.ensure_big_format();
+                v.ensure_big_format();
+                lehmer_matrix(u, v, A, B, C, D);
+            }
+            if (B == 0) {
+                BigInteger quotient, remainder;
+                divmod(u, v, quotient, remainder);
+                u.swap(v);
+                v.swap(remainder);
+                su.submul(quotient, sv);
+                su.swap(sv);
+            } else {
+                lehmer_apply(u, v, A, B, C, D, t1, t2);
+                BigInteger new_su = from_cofactor(A) * su;
+                new_su.addmul(from_cofactor(B), sv);
+                BigInteger new_sv = from_cofactor(C) * su;
+                new_sv.addmul(from_cofactor(D), sv);
+                su = std::move(new_su);
+                sv = std::move(new_sv);
+            }
+            u.try_optimize();
+            v.try_optimize();
+        }
+
+        x = (a < BigInteger(0)) ? -su : su;
+        y = (u - x * a) / b;
+        return u;
+    }
+
+    // --- Пакетные операции ---
+    // out[i] = a[i] op b[i] для i < count. out может совпадать с a или b; память элементов out
+    // переиспользуется. Большие пакеты делятся между потоками WorkerPool (каждый поток - со своей
+    // рабочей памятью), маленькие выполняются в вызывающем потоке
+
+    static void add_batch(const BigInteger* a, const BigInteger* b, BigInteger* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += limb_count(a[i]) + limb_count(b[i]);
+        run_batch(count, work, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (&out[i] == &b[i]) {
+                    out[i] += a[i];
+                } else {
+                    if (&out[i] != &a[i]) out[i] = a[i];
+                    out[i] += b[i];
+                }
+            }
+        });
+    }
+
+    static void sub_batch(const BigInteger* a, const BigInteger* b, BigInteger* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += limb_count(a[i]) + limb_count(b[i]);
+        run_batch(count, work, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (&out[i] == &b[i] && &out[i] != &a[i]) { // a - b = -(b - a)
+                    out[i] -= a[i];
+                    out[i].negate();
+                } else {
+                    if (&out[i] != &a[i]) out[i] = a[i];
+                    out[i] -= b[i];
+                }
+            }
+        });
+    }
+
+    static void mul_batch(const BigInteger* a, const BigInteger* b, BigInteger* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += limb_count(a[i]) * limb_count(b[i]);
+        run_batch(count, work, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (&out[i] == &a[i]) out[i] *= b[i];
+                else if (&out[i] == &b[i]) out[i] *= a[i];
+                else multiply_into(a[i], b[i], out[i]);
+            }
+        });
+    }
+
+    // out[i] = a[i] % m[i] (знак остатка - как у a[i], как у оператора %)
+    static void mod_batch(const BigInteger* a, const BigInteger* m, BigInteger* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += division_work(a[i], m[i]);
+        run_batch(count, work, [=](size_t begin, size_t end) {
+            BigInteger quotient; // Общий для куска: буфер частного переиспользуется
+            for (size_t i = begin; i < end; ++i) divmod(a[i], m[i], quotient, out[i]);
+        });
+    }
+
+    // out[i] = a[i] % m для общего модуля
+    static void mod_batch(const BigInteger* a, const BigInteger& m, BigInteger* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += division_work(a[i], m);
+        run_batch(count, work, [=, &m](size_t begin, size_t end) {
+            BigInteger quotient;
+            for (size_t i = begin; i < end; ++i) divmod(a[i], m, quotient, out[i]);
+        });
+    }
+
+    // out[i] = -1, 0 или 1 для a[i] < b[i], a[i] == b[i], a[i] > b[i]
+    static void compare_batch(const BigInteger* a, const BigInteger* b, int* out, size_t count) {
+        size_t work = 0;
+        for (size_t i = 0; i < count; ++i) work += limb_count(a[i]);
+        run_batch(count, work, [=](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) out[i] = a[i].compare(b[i]);
+        });
+    }
+
+    // Контекст арифметики по фиксированному модулю (определен после класса)
+    class ModContext;
+
+    // base^exponent по модулю |modulus|, результат в [0, |modulus|).
+    // При modulus == 0 или exponent < 0 результат равен 0. Для многих вызовов с одним модулем
+    // выгоднее один раз создать ModContext и вызывать его pow
+    static BigInteger powmod(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus) {
+        ModContext context(modulus);
+        return context.pow(base, exponent);
+    }
+
+    // Квадрат числа (отдельный путь: на больших числах вдвое меньше прямых преобразований NTT)
+    BigInteger square() const {
+        BigInteger result;
+        multiply_into(*this, *this, result);
+        return result;
+    }
+
+    // Возведение в степень (бинарное, слева направо): log2(exponent) возведений в квадрат
+    // через square() и умножения на исходное число по единичным битам показателя.
+    // Младшие нулевые биты основания выносятся в итоговый сдвиг: (m * 2^t)^e = m^e * 2^(t*e)
+    BigInteger pow(unsigned int exponent) const {
+        if (exponent == 0) return BigInteger(1);
+        if (is_zero() || exponent == 1) return *this;
+
+        size_t trailing_zeros = trailing_zero_bits();
+        BigInteger base = *this;
+        if (trailing_zeros != 0) base >>= (int)trailing_zeros; // Сдвиг точен, знак сохраняется
+
+        BigInteger result = base;
+        int top_bit = 31 - __builtin_clz(exponent);
+        for (int bit = top_bit - 1; bit >= 0; --bit) {
+            result = result.square();
+            if ((exponent >> bit) & 1) result *= base;
+        }
+        if (trailing_zeros != 0) result <<= (int)(trailing_zeros * exponent);
+        return result;
+    }
+
+    // --- Корни и точные степени ---
+
+    // Целый квадратный корень floor(sqrt(x)); у отрицательных чисел - 0
+    BigInteger isqrt() const { return iroot(2); }
+
+    // Целый корень степени n с округлением к нулю: floor(|x|^(1/n)) со знаком x.
+    // При n == 0 и при x < 0 с четным n результат равен 0
+    BigInteger iroot(unsigned int n) const {
+        if (n == 0 || (sign() < 0 && n % 2 == 0)) return BigInteger(0);
+        if (is_zero() || n == 1) return *this;
+        if (sign() > 0) return root_floor(*this, n);
+        BigInteger magnitude = *this;
+        magnitude.negate();
+        BigInteger root = root_floor(magnitude, n);
+        root.negate();
+        return root;
+    }
+
+    // Является ли x точной степенью a^k с целым a и k >= 2 (0, 1 и -1 - являются)
+    bool is_perfect_power() const {
+        BigInteger base;
+        unsigned int exponent;
+        return is_perfect_power(base, exponent);
+    }
+
+    // То же с разложением x = base^exponent с наибольшим показателем
+    // (0 = 0^2, 1 = 1^2, -1 = (-1)^3; если x не степень - base = x, exponent = 1).
+    // Показатели перебираются простые (решето до bit_length): если x = r^p, дальше
+    // раскладывается r. У отрицательных x показатель нечетный
+    bool is_perfect_power(BigInteger& base, unsigned int& exponent) const {
+        base = *this;
+        exponent = 1;
+        size_t bits = bit_length();
+        if (bits <= 1) { // 0, 1 и -1
+            exponent = sign() < 0 ? 3 : 2;
+            return true;
+        }
+        std::vector<bool> composite(bits + 1, false);
+        for (size_t d = 2; d * d <= bits; ++d) {
+            if (!composite[d]) for (size_t m = d * d; m <= bits; m += d) composite[m] = true;
+        }
+        for (unsigned int p = sign() < 0 ? 3 : 2; p <= base.bit_length(); ++p) {
+            BigInteger root;
+            if (composite[p] || !base.exact_root(p, root)) continue;
+            base = std::move(root); // У корня наибольший показатель меньше в p раз: p проверяется снова
+            exponent *= p;
+            --p;
+        }
+        return exponent > 1;
+    }
+
+    // --- Простые числа ---
+
+    // Вероятностная проверка простоты (x < 2 - не простые). Числа до 64 бит проверяются точно,
+    // большие - пробным делением на простые меньше PRIME_TRIAL_LIMIT и тестом Baillie - PSW
+    // (Миллер - Рабин по основанию 2 и сильный тест Лукаса), плюс extra_rounds раундов
+    // Миллера - Рабина по следующим простым основаниям
+    bool is_probable_prime(int extra_rounds = 0) const {
+        if (sign() <= 0) return false;
+        if (bit_length() <= 64) return is_prime_u64(magnitude_bits(0));
+        if ((magnitude_bits(0) & 1) == 0) return false;
+
+        size_t count = small_prime_count(PRIME_TRIAL_LIMIT);
+        std::vector<unsigned int> residues(count);
+        small_prime_residues(count, residues.data());
+        for (size_t i = 0; i < count; ++i) {
+            if (residues[i] == 0) return false;
+        }
+        return probable_prime_test(extra_rounds);
+    }
+
+    // Наименьшее (вероятно) простое число, большее x (для x < 2 - число 2).
+    // Нечетные кандидаты идут окнами: остатки начала окна от деления на малые простые считаются
+    // один раз (small_prime_residues) и сдвигаются от окна к окну, решето вычеркивает кратные,
+    // тест Baillie - PSW получают только оставшиеся. Начиная с PRIME_PARALLEL_BITS бит кандидаты
+    // окна проверяются в потоках пула; кандидаты после уже найденного простого пропускаются,
+    // а все меньшие проверяются, поэтому результат тот же, что и при последовательном поиске
+    BigInteger next_prime() const {
+        if (sign() <= 0) return BigInteger(2);
+        if (bit_length() <= 62) { // Следующее простое меньше 2 * x < 2^63
+            unsigned long long candidate = magnitude_bits(0);
+            if (candidate < 2) return BigInteger(2);
+            candidate += 1 + (candidate & 1);
+            while (!is_prime_u64(candidate)) candidate += 2;
+            return BigInteger((long long)candidate);
+        }
+
+        BigInteger start = *this + BigInteger(1);
+        if ((start.magnitude_bits(0) & 1) == 0) ++start;
+        size_t bits = start.bit_length();
+        size_t window = 2 * bits; // Нечетных кандидатов в окне (средний промежуток ~0.35 * bits)
+        size_t limit = bits * 32;
+        if (limit > PRIME_SIEVE_LIMIT) limit = PRIME_SIEVE_LIMIT;
+        size_t count = small_prime_count((unsigned int)limit);
+        const std::vector<unsigned int>& primes = small_primes();
+        std::vector<unsigned int> residues(count);
+        start.small_prime_residues(count, residues.data());
+
+        std::vector<bool> composite(window);
+        std::vector<size_t> candidates;
+        bool parallel = bits >= PRIME_PARALLEL_BITS && WorkerPool::instance().threads() > 1;
+        for (;;) {
+            composite.assign(window, false);
+            for (size_t k = 1; k < count; ++k) { // Кандидаты нечетны, двойка пропускается
+                size_t p = primes[k];
+                size_t r = residues[k];
+                // start + 2i делится на p при 2i = -r (mod p)
+                size_t first = r == 0 ? 0 : (p - r) % 2 == 0 ? (p - r) / 2 : (2 * p - r) / 2;
+                for (size_t i = first; i < window; i += p) composite[i] = true;
+                residues[k] = (unsigned int)((r + 2 * window) % p);
+            }
+            candidates.clear();
+            for (size_t i = 0; i < window; ++i) {
+                if (!composite[i]) candidates.push_back(i);
+            }
+
+            std::atomic<size_t> found(candidates.size()); // Наименьший индекс найденного простого
+            auto test = [&](size_t begin, size_t end) {
+                for (size_t j = begin; j < end && j < found.load(); ++j) {
+                    BigInteger candidate = start + 2 * candidates[j];
+                    if (!candidate.probable_prime_test(0)) continue;
+                    size_t current = found.load();
+                    while (j < current && !found.compare_exchange_weak(current, j)) {}
+                    return;
+                }
+            };
+            if (parallel) {
+                WorkerPool::instance().parallel_for(candidates.size(), 1, test);
+            } else {
+                test(0, candidates.size());
+            }
+            if (found.load() < candidates.size()) {
+                return start + 2 * candidates[found.load()];
+            }
+            start += 2 * window;
+        }
+    }
+
+    BigInteger& operator/=(const BigInteger& other) {
+        BigInteger remainder;
+        divmod(*this, other, *this, remainder);
+        return *this;
+    }
+
+    BigInteger operator/(const BigInteger& other) const {
+        BigInteger result = *this;
+        result /= other;
+        return result;
+    }
+
+    BigInteger& operator%=(const BigInteger& other) {
+        BigInteger quotient;
+        divmod(*this, other, quotient, *this);
+        return *this;
+    }
+
+    BigInteger operator%(const BigInteger& other) const {
+        BigInteger result = *this;
+        result %= other;
+        return result;
+    }
+
+    // --- Операции со встроенными целыми ---
+    // Аргумент встроенного целого типа (до 64 бит) не превращается во временный BigInteger:
+    // знаковые типы приводятся к int64_t, беззнаковые - к uint64_t, и число обрабатывается
+    // однопроходными ядрами для одного блока (add_1, sub_1, mul_1, divmod_1)
+
+    template <typename T, typename R>
+    using IfInteger = typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                              sizeof(T) <= sizeof(long long), R>::type;
+
+    template <typename T> IfInteger<T, BigInteger&> operator+=(T b) { return add_integer(to_integer(b), false); }
+    template <typename T> IfInteger<T, BigInteger&> operator-=(T b) { return add_integer(to_integer(b), true); }
+    template <typename T> IfInteger<T, BigInteger&> operator*=(T b) { return mul_integer(to_integer(b)); }
+    template <typename T> IfInteger<T, BigInteger&> operator/=(T b) { return div_integer(to_integer(b), false); }
+    template <typename T> IfInteger<T, BigInteger&> operator%=(T b) { return div_integer(to_integer(b), true); }
+
+    template <typename T> IfInteger<T, BigInteger> operator+(T b) const & {
+        BigInteger result = *this;
+        result += b;
+        return result;
+    }
+
+    template <typename T> IfInteger<T, BigInteger> operator-(T b) const & {
+        BigInteger result = *this;
+        result -= b;
+        return result;
+    }
+
+    template <typename T> IfInteger<T, BigInteger> operator*(T b) const & { // Без копии множимого
+        return product_integer(to_integer(b));
+    }
+
+    template <typename T> IfInteger<T, BigInteger> operator/(T b) const & {
+        BigInteger result = *this;
+        result /= b;
+        return result;
+    }
+
+    template <typename T> IfInteger<T, BigInteger> operator%(T b) const & { // Без копии делимого
+        return remainder_integer(to_integer(b));
+    }
+
+    // Временный левый операнд меняется на месте
+    template <typename T> IfInteger<T, BigInteger> operator+(T b) && { return std::move(*this += b); }
+    template <typename T> IfInteger<T, BigInteger> operator-(T b) && { return std::move(*this -= b); }
+    template <typename T> IfInteger<T, BigInteger> operator*(T b) && { return std::move(*this *= b); }
+    template <typename T> IfInteger<T, BigInteger> operator/(T b) && { return std::move(*this /= b); }
+    template <typename T> IfInteger<T, BigInteger> operator%(T b) && { return std::move(*this %= b); }
+
+    template <typename T> IfInteger<T, bool> operator==(T b) const { return compare_integer(to_integer(b)) == 0; }
+    template <typename T> IfInteger<T, bool> operator!=(T b) const { return compare_integer(to_integer(b)) != 0; }
+    template <typename T> IfInteger<T, bool> operator<(T b) const { return compare_integer(to_integer(b)) < 0; }
+    template <typename T> IfInteger<T, bool> operator<=(T b) const { return compare_integer(to_integer(b)) <= 0; }
+    template <typename T> IfInteger<T, bool> operator>(T b) const { return compare_integer(to_integer(b)) > 0; }
+    template <typename T> IfInteger<T, bool> operator>=(T b) const { return compare_integer(to_integer(b)) >= 0; }
+
+    // --- Унарные операторы ---
+    BigInteger operator+() const {
+        return *this; // Унарный плюс ничего не меняет
+    }
+
+    BigInteger operator-() const & {
+        BigInteger result = *this;
+        result.negate(); // -0 это 0, -SMALL_INT_MIN переводится в big формат
+        return result;
+    }
+
+    BigInteger operator-() && {
+        negate();
+        return std::move(*this);
+    }
+
+    // Префиксные инкремент/декремент (add_1/sub_1 по блокам, см. add_integer)
+    BigInteger& operator++() {
+        return *this += 1;
+    }
+
+    BigInteger& operator--() {
+        return *this -= 1;
+    }
+
+    // Постфиксные инкремент/декремент
+    BigInteger operator++(int) {
+        BigInteger temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    BigInteger operator--(int) {
+        BigInteger temp = *this;
+        --(*this);
+        return temp;
+    }
+
+    // --- Битовые операторы ---
+    // Семантика дополнительного кода бесконечной длины (как у int): -1 & x == x, ~x == -x - 1.
+    // Дополнительный код не строится: см. bitwise_assign
+
+    BigInteger& operator&=(const BigInteger& other) { return bitwise_assign<BitAnd>(other); }
+    BigInteger& operator|=(const BigInteger& other) { return bitwise_assign<BitOr>(other); }
+    BigInteger& operator^=(const BigInteger& other) { return bitwise_assign<BitXor>(other); }
+
+    BigInteger operator&(const BigInteger& other) const & {
+        BigInteger result = *this;
+        result &= other;
+        return result;
+    }
+
+    BigInteger operator&(const BigInteger& other) && {
+        *this &= other;
+        return std::move(*this);
+    }
+
+    BigInteger operator|(const BigInteger& other) const & {
+        BigInteger result = *this;
+        result |= other;
+        return result;
+    }
+
+    BigInteger operator|(const BigInteger& other) && {
+        *this |= other;
+        return std::move(*this);
+    }
+
+    BigInteger operator^(const BigInteger& other) const & {
+        BigInteger result = *this;
+        result ^= other;
+        return result;
+    }
+
+    BigInteger operator^(const BigInteger& other) && {
+        *this ^= other;
+        return std::move(*this);
+    }
+
+    BigInteger operator~() const & {
+        BigInteger result = *this;
+        result.complement();
+        return result;
+    }
+
+    BigInteger operator~() && {
+        complement();
+        return std::move(*this);
+    }
+
+    // Сдвиги работают с модулем: правый сдвиг отрицательного числа округляет к нулю
+    // (-5 >> 1 == -2), а не вниз, как арифметический сдвиг дополнительного кода
+    BigInteger& operator<<=(int shift) {
+        if (shift < 0) return *this >>= (-shift); // Для отрицательного сдвига - это правый сдвиг
+        if (shift == 0 || is_zero()) return *this;
+        if (is_small_value && shift < BIGINT_SMALL_BITS - 1) { // Результат может остаться в small_value
+            small_int_t value;
+            if (!__builtin_mul_overflow(small_value, (small_int_t)1 << shift, &value)) {
+                small_value = value;
+                return *this;
+            }
+        }
+        shift_left_from(*this, shift);
+        return *this;
+    }
+
+    // Сдвинутые блоки сразу пишутся в результат, без копии исходного числа
+    BigInteger operator<<(int shift) const & {
+        if (shift <= 0 || is_small_value) {
+            BigInteger result = *this;
+            result <<= shift;
+            return result;
+        }
+        BigInteger result;
+        result.shift_left_from(*this, shift);
+        return result;
+    }
+
+    BigInteger operator<<(int shift) && {
+        *this <<= shift;
+        return std::move(*this);
+    }
+
+    BigInteger& operator>>=(int shift) {
+        if (shift < 0) return *this <<= (-shift); // Для отрицательного сдвига - это левый сдвиг
+        if (shift == 0 || is_zero()) return *this;
+        if (is_small_value) { // Деление на степень двойки с округлением к нулю
+            if (shift < BIGINT_SMALL_BITS - 1) small_value /= (small_int_t)1 << shift;
+            else small_value = (shift == BIGINT_SMALL_BITS - 1 && small_value == SMALL_INT_MIN) ? -1 : 0;
+            return *this;
+        }
+        shift_right_from(*this, shift);
+        return *this;
+    }
+
+    BigInteger operator>>(int shift) const & {
+        if (shift <= 0 || is_small_value) {
+            BigInteger result = *this;
+            result >>= shift;
+            return result;
+        }
+        BigInteger result;
+        result.shift_right_from(*this, shift);
+        return result;
+    }
+
+    BigInteger operator>>(int shift) && {
+        *this >>= shift;
+        return std::move(*this);
+    }
+
+    // Количество значащих битов модуля (у нуля - 0)
+    size_t bit_length() const {
+        MagnitudeView view(*this);
+        if (view.size == 0 || view.limbs[view.size - 1] == 0) return 0;
+        return view.size * get_bits_per_limb() - count_leading_zeros(view.limbs[view.size - 1]);
+    }
+
+    // 64 бита модуля, начиная с бита shift (биты за пределами числа - нули).
+    // Позволяет читать старшие биты без копирования и перевода в строку
+    unsigned long long magnitude_bits(size_t shift) const {
+        MagnitudeView view(*this);
+        unsigned long long result = 0;
+        for (int i = 0; i * get_bits_per_limb() < 64; ++i) {
+            size_t offset = (size_t)i * get_bits_per_limb();
+            result |= (unsigned long long)extract_bits(view.limbs, view.size, shift + offset) << offset;
+        }
+        return result;
+    }
+
+    // --- Вывод (нужен ostream) ---
+    // Десятичные цифры пишутся в поток по мере получения, без промежуточной строки на все число
+    friend std::ostream& operator<<(std::ostream& os, const BigInteger& num) {
+        if (num.is_small_value) { // Цифры модуля с конца буфера (long long не вмещает 128 бит)
+            char buffer[48];
+            char* p = buffer + sizeof(buffer);
+            *--p = '\0';
+            small_uint_t magnitude = small_magnitude(num.small_value);
+            do {
+                *--p = (char)('0' + (int)(magnitude % 10));
+                magnitude /= 10;
+            } while (magnitude != 0);
+            if (num.small_value < 0) *--p = '-';
+            os << p;
+            return os;
+        }
+
+        if (num.is_negative) os << '-';
+        BigInteger magnitude = num;
+        magnitude.is_negative = false;
+        write_decimal(os, magnitude, 0);
+        trim_radix_cache(RADIX_CACHE_KEEP_LIMBS);
+        return os;
+    }
+
+    // Десятичная запись числа
+    std::string toString() const {
+        std::ostringstream oss;
+        oss << *this;
+        return oss.str();
+    }
+
+    // Освобождение кэша степеней оснований, накопленного переводами в текущем потоке.
+    // Без вызова кэш ограничен: записи длиннее RADIX_CACHE_KEEP_LIMBS блоков не переживают перевод
+    static void clear_caches() { trim_radix_cache(0); }
+
+    // --- Ввод (нужен istream) ---
+    // Читает слово до пробела и разбирает его как десятичное число (по правилам конструктора от строки)
+    friend std::istream& operator>>(std::istream& is, BigInteger& num) {
+        std::string word;
+        if (is >> word) num = BigInteger(word);
+        return is;
+    }
+
+    // --- Двоичный формат (см. BinaryFormat) ---
+
+    // Количество 64-битных слов модуля в двоичной записи
+    size_t binary_words() const { return (bit_length() + 63) / 64; }
+
+    // Слова модуля без слова размера и знака (столбцовый файл хранит их отдельно)
+    void write_words(std::ostream& os) const {
+        MagnitudeView view(*this);
+        size_t words = binary_words();
+        if (BinaryFormat::host_little_endian()) { // Блоки в памяти уже лежат словами little endian
+            size_t bytes = view.size * sizeof(limb_t) < words * 8 ? view.size * sizeof(limb_t) : words * 8;
+            static const char zeros[8] = {};
+            os.write((const char*)view.limbs, bytes);
+            os.write(zeros, words * 8 - bytes); // Нечетное число 32-битных блоков
+            return;
+        }
+        unsigned char buffer[512 * 8];
+        for (size_t i = 0; i < words; i += 512) {
+            size_t chunk = words - i < 512 ? words - i : 512;
+            for (size_t j = 0; j < chunk; ++j) BinaryFormat::store(buffer + 8 * j, magnitude_bits(64 * (i + j)));
+            os.write((const char*)buffer, chunk * 8);
+        }
+    }
+
+    // Запись числа: слово (количество слов << 1 | знак) и слова модуля
+    void write_binary(std::ostream& os) const {
+        size_t words = binary_words();
+        unsigned char header[8];
+        bool negative = words != 0 && MagnitudeView(*this).negative;
+        BinaryFormat::store(header, (unsigned long long)words << 1 | (negative ? 1 : 0));
+        os.write((const char*)header, 8);
+        write_words(os);
+    }
+
+    // Чтение записи write_binary; false - поток закончился раньше конца записи
+    // (в том числе если слово размера повреждено и обещает больше данных, чем есть в потоке)
+    static bool read_binary(std::istream& is, BigInteger& out) {
+        unsigned char header[8];
+        if (!is.read((char*)header, 8)) return false;
+        unsigned long long value = BinaryFormat::load(header);
+        size_t words = (size_t)(value >> 1);
+        out.assign_small(0);
+        if (words == 0) return true;
+        if (words > ((size_t)-1 >> 4)) return false; // Поврежденный размер
+
+        size_t chunk = BinaryFormat::READ_CHUNK_WORDS;
+        if (BinaryFormat::host_little_endian()) {
+            const size_t limbs_per_word = 8 / sizeof(limb_t);
+            out.is_small_value = false;
+            for (size_t done = 0; done < words; done += chunk) {
+                if (chunk > words - done) chunk = words - done;
+                out.resize((done + chunk) * limbs_per_word);
+                if (!is.read((char*)(out.digits + done * limbs_per_word), chunk * 8)) {
+                    out = BigInteger(0);
+                    return false;
+                }
+            }
+            out.is_negative = (value & 1) != 0;
+            out.normalize();
+            out.try_optimize();
+            return true;
+        }
+        std::vector<unsigned char> buffer;
+        for (size_t done = 0; done < words; done += chunk) {
+            if (chunk > words - done) chunk = words - done;
+            buffer.resize((done + chunk) * 8);
+            if (!is.read((char*)buffer.data() + done * 8, chunk * 8)) return false;
+        }
+        out = from_words(buffer.data(), words, (value & 1) != 0);
+        return true;
+    }
+
+    // Число из слов модуля в двоичном формате (например, из отображенного в память ColumnFile)
+    static BigInteger from_words(const unsigned char* words, size_t count, bool negative) {
+        BigInteger result;
+        if (count == 0) return result;
+        const size_t limbs_per_word = 8 / sizeof(limb_t);
+        result.is_small_value = false;
+        result.resize(count * limbs_per_word);
+        if (BinaryFormat::host_little_endian()) {
+            memcpy(result.digits, words, count * 8);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                unsigned long long word = BinaryFormat::load(words + 8 * i);
+                for (size_t j = 0; j < limbs_per_word; ++j) {
+                    result.digits[i * limbs_per_word + j] = (limb_t)(word >> (j * get_bits_per_limb()));
+                }
+            }
+        }
+        result.is_negative = negative;
+        result.normalize();
+        result.try_optimize();
+        return result;
+    }
+
+};
+
+// --- Модульная арифметика ---
+
+// Контекст арифметики по фиксированному модулю m: все предвычисления делаются в конструкторе
+// и переиспользуются во всех вызовах mul/pow. Для нечетного m используется умножение Монтгомери
+// (вычеты хранятся в виде x * R mod m, R = 2^(bits * n), n - количество блоков m),
+// для четного - редукция Барретта с mu = floor(2^(2 * bits * n) / m).
+// Возведение в степень - скользящим окном по нечетным степеням основания.
+// Внутри вызова вычеты - массивы ровно из n блоков, память выделяется один раз на вызов
+template <typename Limb>
+class BasicBigInteger<Limb>::ModContext {
+private:
+    BigInteger m;          // Модуль (положительный; 0 - вырожденный контекст, все результаты 0)
+    size_t n;              // Количество блоков модуля
+    bool montgomery;       // Нечетный модуль - Монтгомери, четный - Барретт
+    limb_t m_inv_limb;     // -m^(-1) mod 2^bits (Монтгомери)
+    BigInteger m_inv;      // -m^(-1) mod R (Монтгомери для больших модулей)
+    BigInteger r_squared;  // R^2 mod m (перевод в форму Монтгомери)
+    BigInteger mu;         // floor(2^(2 * bits * n) / m) (Барретт)
+
+    // Рабочая память одного вызова: модуль и предвычисленная величина, дополненные нулями
+    // до фиксированной длины, и буферы для произведения и редукции
+    struct Workspace {
+        ScratchBuffer<limb_t> storage;
+        limb_t* mod;     // n блоков
+        limb_t* inv;     // -m^(-1) mod R (n блоков) или mu (n + 2 блока)
+        limb_t* product; // 2n + 2 блока
+        limb_t* temp;    // 4n + 4 блока
+
+        explicit Workspace(const ModContext& ctx) : storage(8 * ctx.n + 8) {
+            mod = storage.data();
+            inv = mod + ctx.n;
+            product = inv + ctx.n + 2;
+            temp = product + 2 * ctx.n + 2;
+            copy_padded(ctx.m, mod, ctx.n);
+            copy_padded(ctx.montgomery ? ctx.m_inv : ctx.mu, inv, ctx.n + 2);
+        }
+    };
+
+    // Модуль неотрицательного x в виде count блоков (x обязан в них поместиться)
+    static void copy_padded(const BigInteger& x, limb_t* out, size_t count) {
+        MagnitudeView view(x);
+        size_t used = view.size < count ? view.size : count;
+        memcpy(out, view.limbs, used * sizeof(limb_t));
+        memset(out + used, 0, (count - used) * sizeof(limb_t));
+    }
+
+    // Пословная редукция Монтгомери: t (2n + 1 блок, t < m * R) -> t * R^(-1) mod m в out.
+    // Если q_out не нулевой, туда записываются множители u_i: q = sum(u_i * 2^(bits * i)),
+    // t + q * m делится на R (при t = 1 это -m^(-1) mod R)
+    static void redc_words(limb_t* t, const limb_t* mod, size_t n, limb_t m_inv_limb, limb_t* out, limb_t* q_out) {
+        for (size_t i = 0; i < n; ++i) {
+            limb_t u = t[i] * m_inv_limb;
+            if (q_out) q_out[i] = u;
+            limb_t carry = addmul_1(t + i, mod, n, u);
+            for (size_t j = i + n; carry != 0 && j <= 2 * n; ++j) {
+                t[j] += carry;
+                carry = (t[j] < carry); // Перенос дальше только при переполнении блока
+            }
+        }
+        final_subtract(t + n, mod, n, out);
+    }
+
+    // out = x - m, если x >= m, иначе x (x из n + 1 блока, x < 2m)
+    static void final_subtract(const limb_t* x, const limb_t* mod, size_t n, limb_t* out) {
+        if (x[n] != 0 || compare_limbs(x, n, mod, n) >= 0) {
+            sub_limbs(out, x, n, mod, n);
+        } else {
+            memcpy(out, x, n * sizeof(limb_t));
+        }
+    }
+
+    // Остаток произведения ws.product (2n блоков, < m^2) по модулю m в out (n блоков)
+    void reduce_product(Workspace& ws, limb_t* out) const {
+        limb_t* t = ws.product;
+        t[2 * n] = 0;
+        t[2 * n + 1] = 0;
+
+        if (montgomery) {
+            // Пословная редукция (n проходов addmul_1) выгоднее, пока умножение не дошло до Toom-3
+            if (n < TOOM3_THRESHOLD) {
+                redc_words(t, ws.mod, n, m_inv_limb, out, 0);
+                return;
+            }
+            // Редукция целиком: q = (t mod R) * (-m^(-1)) mod R, (t + q * m) / R -
+            // два полноразмерных умножения через диспетчер
+            limb_t* q = ws.temp;
+            limb_t* qm = ws.temp + 2 * n;
+            mul_limbs(t, n, ws.inv, n, q);
+            mul_limbs(q, n, ws.mod, n, qm);
+            t[2 * n] = add_limbs(t, t, 2 * n, qm, 2 * n);
+            final_subtract(t + n, ws.mod, n, out);
+            return;
+        }
+
+        // Барретт (HAC 14.42), B = 2^bits: q3 = floor(floor(t / B^(n-1)) * mu / B^(n+1)) отличается
+        // от floor(t / m) не более чем на 2, остаток t - q3 * m достаточно считать по модулю B^(n+1)
+        limb_t* q2 = ws.temp;            // (n + 1) + (n + 2) блоков
+        limb_t* r2 = ws.temp + 2 * n + 3; // (n + 1) + n блоков
+        mul_limbs(t + n - 1, n + 1, ws.inv, n + 2, q2);
+        mul_limbs(q2 + n + 1, n + 1, ws.mod, n, r2);
+        sub_limbs(t, t, n + 1, r2, n + 1); // Заем за пределы B^(n+1) отбрасывается
+        while (compare_limbs(t, n + 1, ws.mod, n) >= 0) {
+            sub_limbs(t, t, n + 1, ws.mod, n);
+        }
+        memcpy(out, t, n * sizeof(limb_t));
+    }
+
+    // out = a * b в форме контекста (out может совпадать с a или b)
+    void mul_form(Workspace& ws, const limb_t* a, const limb_t* b, limb_t* out) const {
+        if (a == b) {
+            sqr_limbs(a, n, ws.product);
+        } else {
+            mul_limbs(a, n, b, n, ws.product);
+        }
+        reduce_product(ws, out);
+    }
+
+    // Перевод вычета x (0 <= x < m) в форму контекста: x * R mod m для Монтгомери
+    void to_form(Workspace& ws, const BigInteger& x, limb_t* out) const {
+        copy_padded(x, out, n);
+        if (montgomery) {
+            ScratchBuffer<limb_t> r2(n);
+            copy_padded(r_squared, r2.data(), n);
+            mul_form(ws, out, r2.data(), out);
+        }
+    }
+
+    // Обратный перевод из формы контекста: x * R^(-1) mod m для Монтгомери
+    BigInteger from_form(Workspace& ws, const limb_t* x) const {
+        if (!montgomery) return from_limbs(x, n);
+        memcpy(ws.product, x, n * sizeof(limb_t));
+        memset(ws.product + n, 0, n * sizeof(limb_t));
+        ScratchBuffer<limb_t> result(n);
+        reduce_product(ws, result.data());
+        return from_limbs(result.data(), n);
+    }
+
+    // Ширина окна для показателя из bits битов (минимум умножений на таблицу и ее построение)
+    static int window_bits(size_t bits) {
+        if (bits <= 8) return 1;
+        if (bits <= 24) return 2;
+        if (bits <= 80) return 3;
+        if (bits <= 240) return 4;
+        if (bits <= 672) return 5;
+        return 6;
+    }
+
+    // base^exponent в форме контекста в out (exponent > 0)
+    void pow_form(Workspace& ws, const BigInteger& base, const BigInteger& exponent, limb_t* out) const {
+        size_t bits = exponent.bit_length();
+        int w = window_bits(bits);
+        size_t table_size = (size_t)1 << (w - 1);
+
+        // Таблица нечетных степеней: g, g^3, g^5, ..., g^(2^w - 1)
+        ScratchBuffer<limb_t> table(table_size * n);
+        limb_t* acc = out;
+        to_form(ws, reduce(base), table.data());
+        if (table_size > 1) {
+            mul_form(ws, table.data(), table.data(), acc); // g^2
+            for (size_t i = 1; i < table_size; ++i) {
+                mul_form(ws, table.data() + (i - 1) * n, acc, table.data() + i * n);
+            }
+        }
+
+        // Биты показателя от старшего к младшему; окно - не длиннее w битов, начинается
+        // и заканчивается единицей, поэтому его значение нечетно и есть в таблице
+        MagnitudeView e(exponent);
+        const int limb_bits = get_bits_per_limb();
+        bool started = false;
+        long long i = (long long)bits - 1;
+        while (i >= 0) {
+            if (((e.limbs[i / limb_bits] >> (i % limb_bits)) & 1) == 0) {
+                if (started) mul_form(ws, acc, acc, acc);
+                i--;
+                continue;
+            }
+
+            long long j = i - w + 1 > 0 ? i - w + 1 : 0;
+            while (((e.limbs[j / limb_bits] >> (j % limb_bits)) & 1) == 0) j++;
+            size_t value = 0;
+            for (long long k = i; k >= j; --k) {
+                value = (value << 1) | ((e.limbs[k / limb_bits] >> (k % limb_bits)) & 1);
+            }
+
+            const limb_t* power = table.data() + (value >> 1) * n;
+            if (started) {
+                for (long long k = i; k >= j; --k) mul_form(ws, acc, acc, acc);
+                mul_form(ws, acc, power, acc);
+            } else {
+                memcpy(acc, power, n * sizeof(limb_t));
+                started = true;
+            }
+            i = j - 1;
+        }
+    }
+
+    // out = a + b и out = a - b по модулю m (вычеты в любой форме, out может совпадать с a или b)
+    void add_form(const Workspace& ws, const limb_t* a, const limb_t* b, limb_t* out) const {
+        limb_t carry = add_limbs(out, a, n, b, n);
+        if (carry != 0 || compare_limbs(out, n, ws.mod, n) >= 0) sub_limbs(out, out, n, ws.mod, n);
+    }
+
+    void sub_form(const Workspace& ws, const limb_t* a, const limb_t* b, limb_t* out) const {
+        if (sub_limbs(out, a, n, b, n) != 0) add_limbs(out, out, n, ws.mod, n); // Переносы по модулю B^n
+    }
+
+    bool equal_form(const limb_t* a, const limb_t* b) const { return memcmp(a, b, n * sizeof(limb_t)) == 0; }
+
+public:
+    explicit ModContext(const BigInteger& modulus)
+        : m(modulus), n(0), montgomery(false), m_inv_limb(0) {
+        if (m < BigInteger(0)) m.negate();
+        if (m.is_zero()) return;
+
+        MagnitudeView view(m);
+        n = view.size;
+        montgomery = (view.limbs[0] & 1) != 0;
+        BigInteger b_2n = BigInteger(1) << (int)(2 * n * get_bits_per_limb()); // R^2 = B^(2n)
+
+        if (montgomery) {
+            // Обратный к младшему блоку по модулю 2^bits методом Ньютона:
+            // x = m0 верен в 3 младших битах, каждая итерация удваивает их число
+            limb_t x = view.limbs[0];
+            for (int bits = 3; bits < get_bits_per_limb(); bits *= 2) x *= 2 - view.limbs[0] * x;
+            m_inv_limb = 0 - x;
+            r_squared = b_2n % m;
+
+            // -m^(-1) mod R - множители пословной редукции числа 1
+            if (n >= TOOM3_THRESHOLD) {
+                ScratchBuffer<limb_t> t(2 * n + 1);
+                ScratchBuffer<limb_t> mod(n);
+                ScratchBuffer<limb_t> q(n);
+                ScratchBuffer<limb_t> unused(n);
+                copy_padded(m, mod.data(), n);
+                memset(t.data(), 0, (2 * n + 1) * sizeof(limb_t));
+                t[0] = 1;
+                redc_words(t.data(), mod.data(), n, m_inv_limb, unused.data(), q.data());
+                m_inv = from_limbs(q.data(), n);
+            }
+        } else {
+            mu = b_2n / m;
+        }
+    }
+
+    // Модуль контекста (положительный)
+    const BigInteger& modulus() const { return m; }
+
+    // Вычет x по модулю m в диапазоне [0, m)
+    BigInteger reduce(const BigInteger& x) const {
+        if (n == 0) return BigInteger(0);
+        BigInteger r = x % m;
+        if (r < BigInteger(0)) r += m;
+        return r;
+    }
+
+    // a * b mod m
+    BigInteger mul(const BigInteger& a, const BigInteger& b) const {
+        if (n == 0) return BigInteger(0);
+        Workspace ws(*this);
+        ScratchBuffer<limb_t> x(n);
+        ScratchBuffer<limb_t> y(n);
+        to_form(ws, reduce(a), x.data());
+        copy_padded(reduce(b), y.data(), n);
+        // Монтгомери: (a * R) * b * R^(-1) = a * b, то есть результат уже в обычном виде
+        mul_form(ws, x.data(), y.data(), y.data());
+        return from_limbs(y.data(), n);
+    }
+
+    // base^exponent mod m; при exponent < 0 результат равен 0
+    BigInteger pow(const BigInteger& base, const BigInteger& exponent) const {
+        if (n == 0 || exponent < BigInteger(0)) return BigInteger(0);
+        if (m == BigInteger(1)) return BigInteger(0);
+        if (exponent.is_zero()) return BigInteger(1);
+
+        Workspace ws(*this);
+        ScratchBuffer<limb_t> acc(n);
+        pow_form(ws, base, exponent, acc.data());
+        return from_form(ws, acc.data());
+    }
+
+    // Сильный тест Ферма (раунд Миллера - Рабина) по основанию base для нечетного m > 3:
+    // m - 1 = d * 2^s, d нечетно; m проходит тест, если base^d = 1 или base^(d * 2^r) = -1
+    // для некоторого 0 <= r < s. Составное m проходит не больше чем для четверти оснований.
+    // Возведения в квадрат идут в форме контекста, без обратного перевода
+    bool strong_probable_prime(const BigInteger& base) const {
+        BigInteger m_minus_1 = m - BigInteger(1);
+        size_t s = m_minus_1.trailing_zero_bits();
+        Workspace ws(*this);
+        ScratchBuffer<limb_t> values(3 * n);
+        limb_t* x = values.data();
+        limb_t* one = x + n;
+        limb_t* minus_one = one + n;
+        to_form(ws, BigInteger(1), one);
+        sub_form(ws, ws.mod, one, minus_one); // m - 1 в форме контекста
+        if (reduce(base).is_zero()) return false;
+
+        pow_form(ws, base, m_minus_1 >> (int)s, x);
+        if (equal_form(x, one) || equal_form(x, minus_one)) return true;
+        for (size_t r = 1; r < s; ++r) {
+            mul_form(ws, x, x, x);
+            if (equal_form(x, minus_one)) return true;
+            if (equal_form(x, one)) return false; // Нетривиальный корень из единицы
+        }
+        return false;
+    }
+
+    // Сильный тест Лукаса в варианте "extra strong" (Q = 1) для нечетного m > 3, взаимно простого
+    // с p^2 - 4, при (p^2 - 4 / m) = -1. Последовательность V_0 = 2, V_1 = p, V_(k+1) = p * V_k - V_(k-1);
+    // m + 1 = d * 2^s, d нечетно; m проходит тест, если U_d = 0 и V_d = +-2 либо V_(d * 2^r) = 0 для
+    // некоторого 0 <= r < s - 1. U_d = (2 * V_(d+1) - p * V_d) / (p^2 - 4), поэтому U_d = 0 проверяется
+    // как 2 * V_(d+1) = p * V_d. Пара (V_k, V_(k+1)) идет по битам d: V_2k = V_k^2 - 2,
+    // V_(2k+1) = V_k * V_(k+1) - p - два умножения на бит
+    bool lucas_probable_prime(unsigned int p) const {
+        BigInteger m_plus_1 = m + BigInteger(1);
+        size_t s = m_plus_1.trailing_zero_bits();
+        BigInteger d = m_plus_1 >> (int)s;
+        Workspace ws(*this);
+        ScratchBuffer<limb_t> values(6 * n);
+        limb_t* v = values.data();     // V_k
+        limb_t* w = v + n;             // V_(k+1)
+        limb_t* t = w + n;
+        limb_t* two = t + n;
+        limb_t* minus_two = two + n;
+        limb_t* p_form = minus_two + n;
+        to_form(ws, BigInteger(2), two);
+        sub_form(ws, ws.mod, two, minus_two);
+        to_form(ws, reduce(BigInteger((long long)p)), p_form);
+
+        memcpy(v, two, n * sizeof(limb_t));
+        memcpy(w, p_form, n * sizeof(limb_t));
+        MagnitudeView e(d);
+        const int limb_bits = get_bits_per_limb();
+        for (size_t i = d.bit_length(); i-- > 0;) {
+            mul_form(ws, v, w, t);
+            sub_form(ws, t, p_form, t); // V_(2k+1)
+            if ((e.limbs[i / limb_bits] >> (i % limb_bits)) & 1) {
+                mul_form(ws, w, w, w);
+                sub_form(ws, w, two, w); // V_(2k+2)
+                memcpy(v, t, n * sizeof(limb_t));
+            } else {
+                mul_form(ws, v, v, v);
+                sub_form(ws, v, two, v); // V_2k
+                memcpy(w, t, n * sizeof(limb_t));
+            }
+        }
+
+        if (equal_form(v, two) || equal_form(v, minus_two)) {
+            add_form(ws, w, w, t);
+            mul_form(ws, p_form, v, w);
+            if (equal_form(t, w)) return true;
+        }
+        memset(t, 0, n * sizeof(limb_t));
+        for (size_t r = 0; r + 1 < s; ++r) {
+            if (equal_form(v, t)) return true;
+            mul_form(ws, v, v, v);
+            sub_form(ws, v, two, v);
+        }
+        return false;
+    }
+};
+
+// Ширина блока по умолчанию: 64 бита (-DBIGINT_LIMB_BITS=32 - 32-битные блоки)
+#ifndef BIGINT_LIMB_BITS
+#define BIGINT_LIMB_BITS 64
+#endif
+
+#if BIGINT_LIMB_BITS == 32
+typedef BasicBigInteger<unsigned int> BigInteger;
+#else
+typedef BasicBigInteger<unsigned long long> BigInteger;
+#endif
+
+// --- Столбцовые файлы ---
+
+// Число внутри отображенного в память столбцового файла: слова модуля без копирования
+struct BigIntegerView {
+    const unsigned char* words; // Слова модуля (BinaryFormat: little endian, младшее первым)
+    size_t size;                // Количество 64-битных слов (0 у нуля)
+    bool negative;
+
+    unsigned long long word(size_t i) const { return BinaryFormat::load(words + 8 * i); }
+
+    // Ведущие нулевые слова пропускаются (в проверенном файле их нет, но view может прийти и извне)
+    size_t bit_length() const {
+        size_t n = size;
+        while (n > 0 && word(n - 1) == 0) --n;
+        if (n == 0) return 0;
+        return n * 64 - __builtin_clzll(word(n - 1));
+    }
+
+    // Копия в BigInteger (на little endian - одно копирование памяти)
+    BigInteger value() const { return BigInteger::from_words(words, size, negative); }
+};
+
+// Столбцовый файл: columns столбцов по rows чисел. Файл отображается в память только для чтения,
+// числа читаются через BigIntegerView без разбора и копирования. Раскладка (слова - 64 бита
+// little endian, смещения - в байтах от начала файла, все кратны 8):
+//   заголовок BinaryFormat "BIGCOLS", количество столбцов, количество строк;
+//   каталог: для каждого столбца смещение таблицы строк и смещение слов модулей;
+//   таблица строк столбца: rows + 1 слов (начало модуля в словах << 1 | знак),
+//   последнее - общее количество слов модулей столбца;
+//   слова модулей столбца подряд: модуль строки row - слова [table[row] >> 1, table[row + 1] >> 1)
+class ColumnFile {
+private:
+    const unsigned char* data;  // Начало файла в памяти
+    size_t length;              // Размер файла в байтах
+    size_t column_count;
+    size_t row_count;
+    void* mapping;              // Отображение файла (nullptr, если файл прочитан в buffer)
+    std::vector<unsigned long long> buffer; // Содержимое файла без mmap (Windows)
+
+    static const size_t DIRECTORY_OFFSET = BinaryFormat::HEADER_BYTES + 16;
+
+    ColumnFile(const ColumnFile&);
+    ColumnFile& operator=(const ColumnFile&);
+
+    unsigned long long word_at(size_t offset) const { return BinaryFormat::load(data + offset); }
+
+    // Проверка каталога и таблиц строк: все обращения get после open не выходят за файл,
+    // а у непустых модулей старшее слово не нулевое (иначе знаменатель "0 0" прошел бы как ненулевой)
+    bool validate() {
+        if (length < DIRECTORY_OFFSET || !BinaryFormat::check_header(data, "BIGCOLS")) return false;
+        unsigned long long columns = word_at(BinaryFormat::HEADER_BYTES);
+        unsigned long long rows = word_at(BinaryFormat::HEADER_BYTES + 8);
+        if (columns > (length - DIRECTORY_OFFSET) / 16 || rows >= length / 8) return false;
+        column_count = (size_t)columns;
+        row_count = (size_t)rows;
+        for (size_t c = 0; c < column_count; ++c) {
+            unsigned long long table = word_at(DIRECTORY_OFFSET + 16 * c);
+            unsigned long long payload = word_at(DIRECTORY_OFFSET + 16 * c + 8);
+            if (table % 8 != 0 || payload % 8 != 0) return false;
+            if (table > length || (length - table) / 8 < row_count + 1 || payload > length) return false;
+            unsigned long long limit = (length - payload) / 8; // Слов модулей, помещающихся в файл
+            unsigned long long previous = 0;
+            for (size_t row = 0; row <= row_count; ++row) {
+                unsigned long long start = word_at((size_t)table + 8 * row) >> 1;
+                if (start < previous || start > limit) return false;
+                // Модули записываются без ведущих нулей: старшее слово непустого модуля не 0
+                if (start > previous && word_at((size_t)(payload + 8 * (start - 1))) == 0) return false;
+                previous = start;
+            }
+        }
+        return true;
+    }
+
+public:
+    ColumnFile() : data(nullptr), length(0), column_count(0), row_count(0), mapping(nullptr) {}
+    ~ColumnFile() { close(); }
+
+    // Отображение файла в память; false - файл не открылся или поврежден
+    bool open(const std::string& path) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        void* p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // Отображение остается действительным и после закрытия файла
+        if (p == MAP_FAILED) {
+            length = 0;
+            return false;
+        }
+        mapping = p;
+        data = (const unsigned char*)p;
+#else
+        std::ifstream in(path.c_str(), std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        length = (size_t)in.tellg();
+        buffer.resize((length + 7) / 8);
+        in.seekg(0);
+        if (!in.read((char*)buffer.data(), length)) {
+            close();
+            return false;
+        }
+        data = (const unsigned char*)buffer.data();
+#endif
+        if (!validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (mapping) munmap(mapping, length);
+#endif
+        mapping = nullptr;
+        std::vector<unsigned long long>().swap(buffer);
+        data = nullptr;
+        length = column_count = row_count = 0;
+    }
+
+    bool is_open() const { return data != nullptr; }
+    size_t columns() const { return column_count; }
+    size_t rows() const { return row_count; }
+
+    // Число из строки row столбца column (без проверки границ)
+    BigIntegerView get(size_t column, size_t row) const {
+        size_t table = (size_t)word_at(DIRECTORY_OFFSET + 16 * column);
+        size_t payload = (size_t)word_at(DIRECTORY_OFFSET + 16 * column + 8);
+        unsigned long long entry = word_at(table + 8 * row);
+        size_t start = (size_t)(entry >> 1);
+        BigIntegerView view;
+        view.words = data + payload + 8 * start;
+        view.size = (size_t)(word_at(table + 8 * (row + 1)) >> 1) - start;
+        view.negative = (entry & 1) != 0;
+        return view;
+    }
+
+    // Запись столбцового файла: get(column, row) возвращает const BigInteger&.
+    // Первый проход считает размеры столбцов для каталога, второй пишет таблицы и модули
+    template <typename Get>
+    static bool write(const std::string& path, size_t columns, size_t rows, Get get) {
+        std::vector<char> stream_buffer((size_t)1 << 20);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(stream_buffer.data(), stream_buffer.size());
+        out.open(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+
+        std::vector<unsigned long long> column_words(columns, 0);
+        for (size_t c = 0; c < columns; ++c) {
+            for (size_t row = 0; row < rows; ++row) column_words[c] += get(c, row).binary_words();
+        }
+
+        BinaryFormat::write_header(out, "BIGCOLS");
+        unsigned char word[8];
+        BinaryFormat::store(word, columns);
+        out.write((const char*)word, 8);
+        BinaryFormat::store(word, rows);
+        out.write((const char*)word, 8);
+        unsigned long long offset = DIRECTORY_OFFSET + 16 * columns;
+        for (size_t c = 0; c < columns; ++c) {
+            BinaryFormat::store(word, offset); // Таблица строк
+            out.write((const char*)word, 8);
+            offset += 8 * (rows + 1);
+            BinaryFormat::store(word, offset); // Слова модулей
+            out.write((const char*)word, 8);
+            offset += 8 * column_words[c];
+        }
+
+        for (size_t c = 0; c < columns; ++c) {
+            unsigned long long start = 0;
+            for (size_t row = 0; row < rows; ++row) {
+                const BigInteger& x = get(c, row);
+                bool negative = x < BigInteger(0);
+                BinaryFormat::store(word, start << 1 | (negative ? 1 : 0));
+                out.write((const char*)word, 8);
+                start += x.binary_words();
+            }
+            BinaryFormat::store(word, start << 1);
+            out.write((const char*)word, 8);
+            for (size_t row = 0; row < rows; ++row) get(c, row).write_words(out);
+        }
+        out.close();
+        return !out.fail();
+    }
+};
+
+#endif // BIGINTEGER_H
@@ -0,0 +1,464 @@
+// Реализация класса Fraction (объявление - Fraction.h)
+#include <iostream>
+#include "Fraction.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+
+// Удаление пробелов из строки
+std::string Fraction::removeSpaces(const std::string& str) {
+    std::string result = str;
+    result.erase(std::remove_if(result.begin(), result.end(), ::isspace), result.end());
+    return result;
+}
+
+// Нахождение НОД двух чисел (алгоритм Лемера из BigInteger; НОД(0, 0) считаем равным 1)
+BigInteger Fraction::gcd(const BigInteger& a, const BigInteger& b) {
+    if (a.is_zero() && b.is_zero()) return BigInteger(1);
+    return BigInteger::gcd(a, b);
+}
+
+// --- Режим нормализации ---
+void Fraction::setLazyNormalization(bool enabled, size_t thresholdBits) {
+    lazy = enabled;
+    lazyThresholdBits = thresholdBits;
+    if (!lazy) reduce();
+}
+
+bool Fraction::isLazyNormalization() const { return lazy; }
+
+// Нормализация дроби
+void Fraction::normalize() {
+    if (denominator.is_zero())
+        throw std::runtime_error("Denominator cannot be zero");
+    if (denominator < BigInteger(0)) {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+    reduced = false;
+    settle();
+}
+
+void Fraction::reduce() const {
+    if (reduced) return;
+    if (numerator.is_zero()) {
+        denominator = BigInteger(1);
+    } else {
+        BigInteger common_divisor = gcd(numerator, denominator);
+        if (common_divisor != BigInteger(1)) {
+            numerator /= common_divisor;
+            denominator /= common_divisor;
+        }
+    }
+    reduced = true;
+    reducedBits = numerator.bit_length() + denominator.bit_length();
+}
+
+void Fraction::settle() {
+    if (!lazy) {
+        reduce();
+        return;
+    }
+    size_t bits = numerator.bit_length() + denominator.bit_length();
+    if (bits > lazyThresholdBits && bits > 2 * reducedBits) reduce();
+}
+
+// Сложение a/b + c/d через НОК знаменателей (Кнут, 4.5.1): для несократимых
+// слагаемых d1 = gcd(b, d), t = a*(d/d1) + c*(b/d1), d2 = gcd(t, d1),
+// результат (t/d2) / ((b/d1)*(d/d2)) уже несократим.
+// В ленивом режиме НОД не ищется: (a*d + c*b) / (b*d)
+void Fraction::addFraction(const BigInteger& c, const BigInteger& d, bool other_reduced) {
+    if (lazy || !reduced || !other_reduced) {
+        if (denominator == d) {
+            numerator += c;
+        } else {
+            numerator *= d;
+            numerator.addmul(c, denominator);
+            denominator *= d;
+        }
+        reduced = false;
+        settle();
+        return;
+    }
+
+    BigInteger d1 = gcd(denominator, d);
+    if (d1 == BigInteger(1)) {
+        numerator *= d;
+        numerator.addmul(c, denominator);
+        denominator *= d;
+    } else {
+        BigInteger b_part = denominator / d1;
+        BigInteger t = numerator * (d / d1);
+        t.addmul(c, b_part);
+        BigInteger d2 = gcd(t, d1);
+        if (d2 == BigInteger(1)) {
+            numerator = std::move(t);
+            denominator = b_part * d;
+        } else {
+            numerator = t / d2;
+            denominator = b_part * (d / d2);
+        }
+    }
+    if (numerator.is_zero()) denominator = BigInteger(1);
+}
+
+// Умножение a/b * c/d с перекрестным сокращением: g1 = gcd(a, d), g2 = gcd(c, b),
+// результат ((a/g1)*(c/g2)) / ((b/g2)*(d/g1)) несократим, а множители меньше исходных.
+// В ленивом режиме числители и знаменатели просто перемножаются
+void Fraction::mulFraction(const BigInteger& c, const BigInteger& d, bool other_reduced) {
+    if (lazy || !reduced || !other_reduced) {
+        numerator *= c;
+        denominator *= d;
+        reduced = false;
+        settle();
+        return;
+    }
+    if (numerator.is_zero() || c.is_zero()) {
+        numerator = BigInteger(0);
+        denominator = BigInteger(1);
+        return;
+    }
+
+    BigInteger g1 = gcd(numerator, d);
+    BigInteger g2 = gcd(c, denominator);
+    bool g1_one = g1 == BigInteger(1), g2_one = g2 == BigInteger(1);
+    if (!g1_one) numerator /= g1;
+    if (!g2_one) denominator /= g2;
+    numerator *= g2_one ? c : c / g2;
+    denominator *= g1_one ? d : d / g1;
+}
+
+// Конструкторы
+Fraction::Fraction()
+    : numerator(0), denominator(1), reduced(true), reducedBits(0), lazy(false), lazyThresholdBits(4096) {}
+
+Fraction::Fraction(const BigInteger& num, const BigInteger& denom)
+    : numerator(num), denominator(denom), reduced(false), reducedBits(0), lazy(false), lazyThresholdBits(4096) {
+    normalize();
+}
+
+Fraction::Fraction(int num, int denom)
+    : numerator(num), denominator(denom), reduced(false), reducedBits(0), lazy(false), lazyThresholdBits(4096) {
+    normalize();
+}
+
+Fraction::Fraction(int num)
+    : numerator(num), denominator(1), reduced(true), reducedBits(0), lazy(false), lazyThresholdBits(4096) {}
+
+Fraction::Fraction(const std::string& str)
+    : reduced(false), reducedBits(0), lazy(false), lazyThresholdBits(4096) {
+    std::string clean_str = removeSpaces(str);
+    size_t slash_pos = clean_str.find('/');
+    if (slash_pos == std::string::npos) {
+        numerator = BigInteger(clean_str);
+        denominator = BigInteger(1);
+    } else {
+        numerator = BigInteger(clean_str.substr(0, slash_pos));
+        denominator = BigInteger(clean_str.substr(slash_pos + 1));
+    }
+    normalize();
+}
+
+// Геттеры (возвращают несократимую форму)
+const BigInteger& Fraction::getNumerator() const { reduce(); return numerator; }
+const BigInteger& Fraction::getDenominator() const { reduce(); return denominator; }
+
+// Проверка на ноль (знаменатель положителен, сокращение не нужно)
+bool Fraction::isZero() const { return numerator.is_zero(); }
+
+// Получение знака дроби
+int Fraction::sign() const {
+    if (numerator.is_zero()) return 0;
+    return (numerator < BigInteger(0)) ? -1 : 1;
+}
+
+// Арифметические операции
+Fraction Fraction::operator-() const {
+    Fraction result = *this;
+    result.numerator = -result.numerator;
+    return result;
+}
+
+Fraction& Fraction::operator+=(const Fraction& other) {
+    if (this == &other) { // Самосложение: удвоение числителя
+        numerator <<= 1;
+        reduced = false;
+        settle();
+        return *this;
+    }
+    addFraction(other.numerator, other.denominator, other.reduced);
+    return *this;
+}
+
+Fraction Fraction::operator+(const Fraction& other) const {
+    Fraction result = *this;
+    result += other;
+    return result;
+}
+
+Fraction& Fraction::operator-=(const Fraction& other) {
+    if (this == &other) {
+        numerator = BigInteger(0);
+        denominator = BigInteger(1);
+        reduced = true;
+        return *this;
+    }
+    addFraction(-other.numerator, other.denominator, other.reduced);
+    return *this;
+}
+
+Fraction Fraction::operator-(const Fraction& other) const {
+    Fraction result = *this;
+    result -= other;
+    return result;
+}
+
+Fraction& Fraction::operator*=(const Fraction& other) {
+    if (this == &other) { // Квадрат несократимой дроби несократим
+        numerator = numerator.square();
+        denominator = denominator.square();
+        settle();
+        return *this;
+    }
+    mulFraction(other.numerator, other.denominator, other.reduced);
+    return *this;
+}
+
+Fraction Fraction::operator*(const Fraction& other) const {
+    Fraction result = *this;
+    result *= other;
+    return result;
+}
+
+Fraction& Fraction::operator/=(const Fraction& other) {
+    if (other.numerator.is_zero())
+        throw std::runtime_error("Division by zero");
+    if (this == &other) {
+        numerator = BigInteger(1);
+        denominator = BigInteger(1);
+        reduced = true;
+        return *this;
+    }
+    // Деление на c/d - умножение на d/c, знак переносится в числитель
+    if (other.numerator < BigInteger(0))
+        mulFraction(-other.denominator, -other.numerator, other.reduced);
+    else
+        mulFraction(other.denominator, other.numerator, other.reduced);
+    return *this;
+}
+
+Fraction Fraction::operator/(const Fraction& other) const {
+    Fraction result = *this;
+    result /= other;
+    return result;
+}
+
+// Операторы сравнения
+// Сравнение - точка наблюдения: обе дроби приводятся к несократимому виду
+bool Fraction::operator==(const Fraction& other) const {
+    reduce();
+    other.reduce();
+    return numerator == other.numerator && denominator == other.denominator;
+}
+
+bool Fraction::operator!=(const Fraction& other) const {
+    return !(*this == other);
+}
+
+bool Fraction::operator<(const Fraction& other) const {
+    reduce();
+    other.reduce();
+    if (denominator == other.denominator) return numerator < other.numerator;
+    // a/b < c/d <=> a*d - c*b < 0 (знаменатели положительны); второе произведение вычитается на месте
+    BigInteger difference = numerator * other.denominator;
+    difference.submul(other.numerator, denominator);
+    return difference.sign() < 0;
+}
+
+bool Fraction::operator<=(const Fraction& other) const {
+    return *this < other || *this == other;
+}
+
+bool Fraction::operator>(const Fraction& other) const {
+    return !(*this <= other);
+}
+
+bool Fraction::operator>=(const Fraction& other) const {
+    return !(*this < other);
+}
+
+// Возведение в степень: числитель и знаменатель возводятся отдельно (BigInteger::pow).
+// Степени взаимно простых чисел взаимно просты, поэтому НОД не нужен
+Fraction Fraction::pow(unsigned int exponent) const {
+    Fraction result;
+    result.numerator = numerator.pow(exponent);
+    result.denominator = denominator.pow(exponent);
+    result.reduced = reduced;
+    result.lazy = lazy;
+    result.lazyThresholdBits = lazyThresholdBits;
+    if (!reduced) result.settle();
+    return result;
+}
+
+// Модуль дроби
+Fraction Fraction::abs() const {
+    if (numerator < BigInteger(0))
+        return -*this;
+    return *this;
+}
+
+// --- Преобразование в double ---
+
+// Старшие 128 битов модуля x (bits = x.bit_length()), выровненные по старшему биту.
+// Если в x больше 128 битов, младшие отбрасываются
+static unsigned __int128 leadingBits128(const BigInteger& x, size_t bits) {
+    if (bits <= 128) {
+        unsigned __int128 value = ((unsigned __int128)x.magnitude_bits(64) << 64) | x.magnitude_bits(0);
+        return value << (128 - bits);
+    }
+    return ((unsigned __int128)x.magnitude_bits(bits - 64) << 64) | x.magnitude_bits(bits - 128);
+}
+
+// Округление q * 2^exponent до double (q < 2^67) с учетом денормализованных чисел.
+// exact: q - точная целая часть значения, sticky - есть ли ненулевая дробная часть.
+// Иначе q известно с погрешностью меньше 5; если значение слишком близко к середине между
+// соседними double, возвращается false и нужен точный расчет
+static bool roundToDouble(unsigned __int128 q, bool exact, bool sticky, long long exponent, double& result) {
+    unsigned long long high = (unsigned long long)(q >> 64);
+    int length = high ? 128 - __builtin_clzll(high) : 64 - __builtin_clzll((unsigned long long)q);
+    long long top = exponent + length - 1; // Двоичный порядок старшего бита
+    long long keep = 53;
+    if (top < -1022) keep -= -1022 - top; // Денормализованное число: значащих битов меньше
+    long long drop = length - keep;
+    if (drop > length) { // Меньше половины наименьшего денормализованного числа
+        result = 0.0;
+        return exact || drop > length + 1;
+    }
+
+    unsigned long long mantissa = (unsigned long long)(q >> drop);
+    unsigned __int128 rest = q & (((unsigned __int128)1 << drop) - 1);
+    unsigned __int128 half = (unsigned __int128)1 << (drop - 1);
+    if (exact) {
+        if (rest > half || (rest == half && (sticky || (mantissa & 1)))) ++mantissa;
+    } else {
+        if (rest + 5 >= half && rest <= half + 5) return false;
+        if (rest > half) ++mantissa;
+    }
+    long long power = exponent + drop;
+    if (power > 2048) power = 2048; // Заведомо за пределами double: ldexp даст бесконечность
+    result = std::ldexp((double)mantissa, (int)power);
+    return true;
+}
+
+// Порядок значения a / b определяется длинами чисел. Оценка: частное старших 128 битов
+// числителя на старшие 64 бита знаменателя - 64-65-битное число с погрешностью меньше 5,
+// его хватает для правильного округления, кроме значений вблизи середины между double
+// (доля таких случаев около 2^-8). Для них частное считается точно делением BigInteger.
+// Дробь не сокращается: отношение от этого не меняется
+double Fraction::toDouble() const {
+    if (numerator.is_zero()) return 0.0;
+    size_t numerator_bits = numerator.bit_length();
+    size_t denominator_bits = denominator.bit_length();
+    long long scale = (long long)numerator_bits - (long long)denominator_bits;
+
+    unsigned __int128 a = leadingBits128(numerator, numerator_bits);
+    unsigned long long b = (unsigned long long)(leadingBits128(denominator, denominator_bits) >> 64);
+    double result;
+    if (!roundToDouble(a / b, false, false, scale - 64, result)) {
+        // Точное частное из 66-67 битов: floor(|a| * 2^shift / b) и признак ненулевого остатка
+        long long shift = 66 - scale;
+        BigInteger dividend = numerator < BigInteger(0) ? -numerator : numerator;
+        BigInteger divisor = denominator;
+        if (shift > 0) dividend <<= (int)shift;
+        else divisor <<= (int)-shift;
+        BigInteger quotient, remainder;
+        BigInteger::divmod(dividend, divisor, quotient, remainder);
+        unsigned __int128 q = ((unsigned __int128)quotient.magnitude_bits(64) << 64) | quotient.magnitude_bits(0);
+        roundToDouble(q, true, !remainder.is_zero(), -shift, result);
+    }
+    return numerator < BigInteger(0) ? -result : result;
+}
+
+void Fraction::toDouble(const Fraction* input, size_t count, double* output) {
+    for (size_t i = 0; i < count; ++i) output[i] = input[i].toDouble();
+}
+
+// Преобразование в строку
+std::string Fraction::toString() const {
+    reduce();
+    std::ostringstream oss;
+    if (denominator == BigInteger(1)) {
+        oss << numerator;
+    } else {
+        oss << numerator << "/" << denominator;
+    }
+    return oss.str();
+}
+
+// Операторы ввода/вывода
+std::ostream& operator<<(std::ostream& os, const Fraction& f) {
+    os << f.toString();
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, Fraction& f) {
+    std::string str;
+    is >> str;
+    f = Fraction(str);
+    return is;
+}
+
+// --- Двоичный формат ---
+
+Fraction Fraction::fromReduced(BigInteger num, BigInteger denom) {
+    Fraction result;
+    result.reducedBits = num.bit_length() + denom.bit_length();
+    result.numerator = std::move(num);
+    result.denominator = std::move(denom);
+    return result;
+}
+
+// Геттеры сокращают дробь в ленивом режиме, поэтому записывается несократимая дробь
+void Fraction::writeBinary(std::ostream& os) const {
+    getNumerator().write_binary(os);
+    denominator.write_binary(os);
+}
+
+bool Fraction::readBinary(std::istream& is, Fraction& out) {
+    BigInteger num, denom;
+    if (!BigInteger::read_binary(is, num) || !BigInteger::read_binary(is, denom)) return false;
+    if (denom <= BigInteger(0) || BigInteger::gcd(num, denom) != 1) return false; // Запись не из writeBinary
+    out = fromReduced(std::move(num), std::move(denom));
+    return true;
+}
+
+bool Fraction::writeColumns(const std::string& path, const Fraction* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) values[i].reduce();
+    return ColumnFile::write(path, 2, count, [values](size_t column, size_t row) -> const BigInteger& {
+        return column == 0 ? values[row].numerator : values[row].denominator;
+    });
+}
+
+bool Fraction::ColumnView::open(const std::string& path) {
+    if (!file.open(path)) return false;
+    bool valid = file.columns() == 2;
+    for (size_t i = 0; valid && i < file.rows(); ++i) { // Знаменатели положительны, дроби несократимы
+        BigIntegerView denom = file.get(1, i);
+        valid = denom.size != 0 && !denom.negative && BigInteger::gcd(file.get(0, i).value(), denom.value()) == 1;
+    }
+    if (!valid) file.close();
+    return valid;
+}
+
+size_t Fraction::ColumnView::size() const { return file.rows(); }
+
+BigIntegerView Fraction::ColumnView::numerator(size_t i) const { return file.get(0, i); }
+
+BigIntegerView Fraction::ColumnView::denominator(size_t i) const { return file.get(1, i); }
+
+Fraction Fraction::ColumnView::operator[](size_t i) const {
+    return fromReduced(numerator(i).value(), denominator(i).value());
+}
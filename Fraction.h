@@ -0,0 +1,117 @@
+#ifndef FRACTION_H
+#define FRACTION_H
+
+#include <iostream>
+#include <string>
+#include "BigInteger.h"
+
+// Рациональное число numerator / denominator (знаменатель положителен).
+// В обычном режиме дробь всегда несократима. В ленивом режиме (setLazyNormalization)
+// сокращение откладывается до наблюдения значения (вывод, сравнение, геттеры)
+// или до превышения порога размера. Режим хранится в самой дроби: новые дроби обычные,
+// результат операции получает режим левого операнда, присваивание копирует режим вместе со значением.
+// Ленивая дробь сокращается и из const-методов, поэтому читать одну const-дробь в ленивом режиме
+// из нескольких потоков одновременно нельзя; дроби в обычном режиме const-методы не изменяют
+class Fraction {
+private:
+    // Числитель и знаменатель изменяются при отложенном сокращении из const-методов
+    mutable BigInteger numerator;   // Числитель (несет знак дроби)
+    mutable BigInteger denominator; // Знаменатель (всегда > 0)
+    mutable bool reduced;           // Дробь заведомо несократима
+    mutable size_t reducedBits;     // Размер в битах после последнего сокращения
+    bool lazy;                      // Включен ли ленивый режим
+    size_t lazyThresholdBits;       // Минимальный суммарный размер в битах для сокращения в ленивом режиме
+
+    // Удаление пробелов из строки
+    static std::string removeSpaces(const std::string& str);
+    // Нахождение НОД двух чисел
+    static BigInteger gcd(const BigInteger& a, const BigInteger& b);
+    // Нормализация дроби: проверка и знак знаменателя, затем сокращение по режиму
+    void normalize();
+    // Сокращение на НОД, если дробь еще не сокращена
+    void reduce() const;
+    // Сокращение после арифметической операции: сразу или, в ленивом режиме, когда размер
+    // превысил порог и вдвое вырос с последнего сокращения
+    void settle();
+    // *this += c / d и *this *= c / d при d > 0
+    void addFraction(const BigInteger& c, const BigInteger& d, bool other_reduced);
+    void mulFraction(const BigInteger& c, const BigInteger& d, bool other_reduced);
+    // Дробь из уже несократимых числителя и знаменателя (> 0), без поиска НОД
+    static Fraction fromReduced(BigInteger num, BigInteger denom);
+
+public:
+    // Конструкторы
+    Fraction();
+    Fraction(const BigInteger& num, const BigInteger& denom);
+    Fraction(int num, int denom);
+    Fraction(int num);
+    Fraction(const std::string& str);
+
+    // Режим отложенного сокращения этой дроби (при выключении дробь сразу сокращается)
+    void setLazyNormalization(bool enabled, size_t thresholdBits = 4096);
+    bool isLazyNormalization() const;
+
+    // Геттеры
+    const BigInteger& getNumerator() const;
+    const BigInteger& getDenominator() const;
+
+    bool isZero() const;
+    int sign() const;
+
+    // Арифметические операции
+    Fraction operator-() const;
+    Fraction& operator+=(const Fraction& other);
+    Fraction operator+(const Fraction& other) const;
+    Fraction& operator-=(const Fraction& other);
+    Fraction operator-(const Fraction& other) const;
+    Fraction& operator*=(const Fraction& other);
+    Fraction operator*(const Fraction& other) const;
+    Fraction& operator/=(const Fraction& other);
+    Fraction operator/(const Fraction& other) const;
+
+    // Операторы сравнения
+    bool operator==(const Fraction& other) const;
+    bool operator!=(const Fraction& other) const;
+    bool operator<(const Fraction& other) const;
+    bool operator<=(const Fraction& other) const;
+    bool operator>(const Fraction& other) const;
+    bool operator>=(const Fraction& other) const;
+
+    Fraction pow(unsigned int exponent) const;
+    Fraction abs() const;
+    // Ближайшее к дроби число double (округление к ближайшему, при равенстве - к четному)
+    double toDouble() const;
+    // Пакетное преобразование: output[i] = input[i].toDouble() для i < count
+    static void toDouble(const Fraction* input, size_t count, double* output);
+    std::string toString() const;
+
+    // Двоичный формат (BinaryFormat): записи BigInteger числителя и знаменателя несократимой дроби.
+    // При чтении сокращение не повторяется; false - поток закончился, знаменатель не положителен
+    // или дробь сократима (такую запись writeBinary не создает)
+    void writeBinary(std::ostream& os) const;
+    static bool readBinary(std::istream& is, Fraction& out);
+
+    // Массив дробей в столбцовый файл ColumnFile: столбец 0 - числители, 1 - знаменатели
+    static bool writeColumns(const std::string& path, const Fraction* values, size_t count);
+
+    // Массив дробей из файла writeColumns: файл отображается в память, числа читаются без разбора
+    class ColumnView {
+    private:
+        ColumnFile file;
+
+    public:
+        // false - файл не открылся, поврежден или это не массив дробей (знаменатель не положителен
+        // или дробь сократима); после успешного open operator[] возвращает несократимые дроби
+        bool open(const std::string& path);
+        size_t size() const;
+        BigIntegerView numerator(size_t i) const;
+        BigIntegerView denominator(size_t i) const;
+        Fraction operator[](size_t i) const;
+    };
+};
+
+// Операторы ввода/вывода
+std::ostream& operator<<(std::ostream& os, const Fraction& f);
+std::istream& operator>>(std::istream& is, Fraction& f);
+
+#endif // FRACTION_H
@@ -0,0 +1,426 @@
+// Замер операций BigInteger и Fraction: время и объем выделенной памяти на операцию.
+// Основной набор замеров выполняется для 32- и 64-битных блоков, размеры - от 1 до 100000 блоков.
+// Сборка: g++ -O2 -std=c++17 -pthread bench_bigint.cpp Fraction.cpp -o bench_bigint
+// (без -march: ядра выбираются по процессору).
+// Запуск: bench_bigint [--json файл] - результаты дополнительно сохраняются в JSON
+// для сравнения между версиями
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BigInteger.h"
+#include "Fraction.h"
+
+// --- Подсчет памяти, выделенной в куче ---
+// Пакетные и параллельные замеры выделяют память и в потоках WorkerPool, поэтому счетчик атомарный
+static std::atomic<size_t> allocated_bytes(0);
+
+static void* counted_malloc(size_t size) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size) { return counted_malloc(size); }
+void* operator new[](size_t size) { return counted_malloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// Число из n псевдослучайных 32-битных частей (старшая часть ненулевая)
+template <typename Number>
+static Number random_number(size_t n, unsigned int seed) {
+    std::vector<int> blocks(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        blocks[i] = (int)seed;
+    }
+    blocks[n - 1] |= 1;
+    return Number(blocks.data(), n);
+}
+
+// --- Результаты для JSON ---
+struct Result {
+    std::string group; // Набор замеров
+    std::string name;  // Операция
+    size_t size;       // Размер операндов
+    const char* unit;  // Единица размера: бит или блоков
+    size_t iterations;
+    double ns;         // Нс на операцию
+    double bytes;      // Байт в куче на операцию
+};
+
+static std::vector<Result> results;
+static std::string current_group;
+static const char* current_unit = "bits";
+
+// Начало набора замеров: заголовок таблицы и группа для следующих результатов
+static void begin_group(const std::string& group, const char* unit, const std::string& title) {
+    current_group = group;
+    current_unit = unit;
+    std::cout << title << std::endl;
+    // Подписи выровнены вручную: setw считает байты, а не буквы UTF-8
+    std::cout << "  операция" << (strcmp(unit, "bits") == 0 ? "     бит" : "  блоков")
+              << "         нс/оп     байт/оп" << std::endl;
+}
+
+// Печать строки результата: нс и байт в куче на одну операцию
+template <typename Op>
+static void measure(const char* name, size_t n, size_t iterations, Op op) {
+    volatile int sink = 0;
+    size_t bytes_before = allocated_bytes;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) sink += op();
+    auto finish = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(finish - start).count() / iterations;
+    double bytes = (double)(allocated_bytes - bytes_before) / iterations;
+
+    std::cout << std::setw(10) << name << std::setw(8) << n
+              << std::setw(14) << std::fixed << std::setprecision(1) << ns
+              << std::setw(12) << bytes << std::endl;
+    (void)sink;
+    results.push_back(Result{ current_group, name, n, current_unit, iterations, ns, bytes });
+}
+
+static std::string json_string(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Все результаты запуска и условия замера (уровень ядер, потоки, время запуска)
+static bool write_json(const char* path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n  \"context\": {\"date\": " << json_string(date)
+        << ", \"cpu_tier\": " << json_string(CpuDispatch::name(CpuDispatch::selected()))
+        << ", \"hardware_threads\": " << std::thread::hardware_concurrency()
+        << ", \"limb_bits\": " << BIGINT_LIMB_BITS << ", \"small_bits\": " << BIGINT_SMALL_BITS << "},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"group\": " << json_string(r.group) << ", \"name\": " << json_string(r.name)
+            << ", \"size\": " << r.size << ", \"unit\": " << json_string(r.unit)
+            << ", \"iterations\": " << r.iterations << std::fixed << std::setprecision(1)
+            << ", \"ns_per_op\": " << r.ns << ", \"bytes_per_op\": " << r.bytes << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return (bool)out;
+}
+
+// Замеры для чисел с блоками типа Limb; размер чисел - в битах
+template <typename Limb>
+static void run_suite() {
+    typedef BasicBigInteger<Limb> Number;
+    const size_t sizes[] = { 1, 2, 3, 8, 64, 1024, 16384, 200000 }; // В 32-битных частях
+
+    ScratchArena::local().reset_stats();
+    begin_group("bigint" + std::to_string(sizeof(Limb) * 8), "bits", "Блоки по " + std::to_string(sizeof(Limb) * 8) + " бит");
+
+    for (size_t n : sizes) {
+        size_t iterations = 20000000 / (n + 16);
+        size_t mul_iterations = 200000000 / (n * n + 1000) + 1;
+        size_t bits = n * 32;
+        Number a = random_number<Number>(n, 1);
+        Number b = random_number<Number>(n, 2);
+        Number c = a;        // Равное a: сравнение проходит все блоки
+        Number small(12345); // Смешанный случай: big и small_value
+        Number wide = a * b + small; // Делимое вдвое длиннее делителя
+        Number negative_b = -b;
+
+        measure("==", bits, iterations, [&]() { return (int)(a == c); });
+        measure("<", bits, iterations, [&]() { return (int)(a < b); });
+        measure("< small", bits, iterations, [&]() { return (int)(small < a); });
+        // Пара += / -= возвращает a к исходному значению, размер числа не растет
+        measure("+= -=", bits, iterations, [&]() { a += b; a -= b; return 0; });
+        measure("-= +=", bits, iterations, [&]() { a -= b; a += b; return 0; });
+        measure("+= small", bits, iterations, [&]() { a += small; a -= small; return 0; });
+        measure("*", bits, mul_iterations, [&]() { return (int)(a * b).bit_length(); });
+        measure("square", bits, mul_iterations, [&]() { return (int)a.square().bit_length(); });
+        measure("/", bits, mul_iterations, [&]() { return (int)(wide / a).bit_length(); });
+        measure("%", bits, mul_iterations, [&]() { return (int)(wide % a).bit_length(); });
+        // Цепочка из временных объектов и совмещенное умножение со сложением
+        measure("a*b+b*a-a", bits, mul_iterations, [&]() { return (int)(a * b + b * a - a).bit_length(); });
+        measure("addmul sm", bits, iterations, [&]() { a.addmul(b, small); a.submul(b, small); return 0; });
+        measure("<< >>", bits, iterations, [&]() { a <<= 13; a >>= 13; return 0; });
+        // Битовые операции: неотрицательные числа (векторный проход) и дополнительный код на лету
+        measure("a & b", bits, iterations, [&]() { return (int)(a & b).bit_length(); });
+        measure("a ^ -b", bits, iterations, [&]() { return (int)(a ^ negative_b).bit_length(); });
+        measure("~a", bits, iterations, [&]() { return (int)(~a).bit_length(); });
+        if (n <= 1024) { // НОД квадратичен: самый большой размер замерять слишком долго
+            Number quarter = random_number<Number>(n / 4 + 1, 3); // Несбалансированный случай
+            Number x, y;
+            measure("gcd", bits, mul_iterations, [&]() { return (int)Number::gcd(a, b).bit_length(); });
+            measure("gcd 4:1", bits, mul_iterations, [&]() { return (int)Number::gcd(a, quarter).bit_length(); });
+            measure("xgcd", bits, mul_iterations, [&]() { return (int)Number::xgcd(a, b, x, y).bit_length(); });
+        }
+    }
+
+    // Статистика рабочей памяти ядер: по ней подбирается размер арены для рабочих потоков
+    ScratchArena::Stats stats = ScratchArena::local().stats();
+    std::cout << "Арена: " << stats.capacity << " байт, пик " << stats.high_water << " байт, из арены "
+              << stats.arena_allocations << ", из кучи " << stats.heap_allocations << std::endl;
+    std::cout << std::endl;
+}
+
+// Пакетное умножение и сложение 4096 пар по 1024 бита: последовательный цикл и пакет
+// на 1, 2, ... потоках (до числа ядер); время - на весь пакет
+static void run_batch_suite() {
+    const size_t count = 4096;
+    std::vector<BigInteger> a, b, out(count);
+    for (size_t i = 0; i < count; ++i) {
+        a.push_back(random_number<BigInteger>(32, (unsigned int)(2 * i + 1)));
+        b.push_back(random_number<BigInteger>(32, (unsigned int)(2 * i + 2)));
+    }
+
+    begin_group("batch", "bits", "Пакеты по " + std::to_string(count) + " пар, 1024 бит");
+    measure("* цикл", 1024, 20, [&]() {
+        for (size_t i = 0; i < count; ++i) out[i] = a[i] * b[i];
+        return 0;
+    });
+    size_t cores = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    for (size_t threads = 1; threads <= cores; threads *= 2) {
+        WorkerPool::instance().set_threads(threads);
+        std::cout << "потоков: " << threads << std::endl;
+        current_group = "batch/threads=" + std::to_string(threads);
+        measure("mul_batch", 1024, 20, [&]() { BigInteger::mul_batch(a.data(), b.data(), out.data(), count); return 0; });
+        measure("add_batch", 1024, 200, [&]() { BigInteger::add_batch(a.data(), b.data(), out.data(), count); return 0; });
+    }
+    WorkerPool::instance().set_threads(0);
+}
+
+// Одно умножение и одно деление чисел из 100000 32-битных частей на 1, 2, ... потоках
+// (до числа ядер): подпроизведения Toom-3 и свертки NTT раздаются потокам пула
+static void run_parallel_suite() {
+    const size_t n = 100000;
+    BigInteger a = random_number<BigInteger>(n, 1);
+    BigInteger b = random_number<BigInteger>(n, 2);
+    BigInteger wide = random_number<BigInteger>(2 * n, 3);
+
+    begin_group("parallel", "bits", "Крупные операнды, " + std::to_string(n * 32) + " бит");
+    size_t cores = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+    for (size_t threads = 1; threads <= cores; threads *= 2) {
+        WorkerPool::instance().set_threads(threads);
+        std::cout << "потоков: " << threads << std::endl;
+        current_group = "parallel/threads=" + std::to_string(threads);
+        measure("*", n * 32, 3, [&]() { return (int)(a * b).bit_length(); });
+        measure("/", n * 32, 1, [&]() { return (int)(wide / a).bit_length(); });
+    }
+    WorkerPool::instance().set_threads(0);
+}
+
+// Сдвиги от 1 до 100000 блоков: на месте (<<= и >>= возвращают число к исходному)
+// и в новый объект; размер - в блоках типа Limb
+template <typename Limb>
+static void run_shift_suite() {
+    typedef BasicBigInteger<Limb> Number;
+    const size_t sizes[] = { 1, 4, 16, 64, 256, 1024, 4096, 16384, 100000 };
+    const size_t parts_per_limb = sizeof(Limb) / sizeof(int);
+
+    begin_group("shift" + std::to_string(sizeof(Limb) * 8), "limbs", "Сдвиги, блоки по " + std::to_string(sizeof(Limb) * 8) + " бит");
+    for (size_t n : sizes) {
+        size_t iterations = 20000000 / (n + 16);
+        Number a = random_number<Number>(n * parts_per_limb, 1);
+        measure("<<= >>=", n, iterations, [&]() { a <<= 13; a >>= 13; return 0; });
+        measure("a << 77", n, iterations, [&]() { return (int)(a << 77).bit_length(); });
+        measure("a >> 77", n, iterations, [&]() { return (int)(a >> 77).bit_length(); });
+    }
+    std::cout << std::endl;
+}
+
+// Перевод в десятичную строку и обратно и вывод в поток для BigInteger; размер - в блоках
+static void run_io_suite() {
+    const size_t sizes[] = { 1, 16, 256, 4096, 100000 };
+    const size_t parts_per_limb = BIGINT_LIMB_BITS / 32;
+
+    begin_group("io", "limbs", "Перевод в строку и из строки, блоки по " + std::to_string(BIGINT_LIMB_BITS) + " бит");
+    for (size_t n : sizes) {
+        size_t iterations = 400000 / (4 * n + 100) + 1;
+        BigInteger a = random_number<BigInteger>(n * parts_per_limb, 1);
+        std::string decimal = a.toString();
+        measure("parse", n, iterations, [&]() { return (int)BigInteger(decimal.c_str()).bit_length(); });
+        measure("toString", n, iterations, [&]() { return (int)a.toString().size(); });
+        measure("ostream <<", n, iterations, [&]() {
+            std::ostringstream os;
+            os << a;
+            return (int)os.tellp();
+        });
+    }
+    std::cout << std::endl;
+}
+
+// Возведение в степень: 3^e с результатом из n блоков и квадрат числа из n блоков
+static void run_pow_suite() {
+    const size_t sizes[] = { 1, 16, 256, 4096, 100000 };
+    const size_t parts_per_limb = BIGINT_LIMB_BITS / 32;
+
+    begin_group("pow", "limbs", "Степени, блоки результата по " + std::to_string(BIGINT_LIMB_BITS) + " бит");
+    BigInteger three(3);
+    for (size_t n : sizes) {
+        size_t iterations = 400000 / (4 * n + 100) + 1;
+        unsigned int exponent = (unsigned int)(n * BIGINT_LIMB_BITS * 100 / 159); // log2(3) ~ 1.59
+        BigInteger half = random_number<BigInteger>((n * parts_per_limb + 1) / 2, 1);
+        measure("3^e", n, iterations, [&]() { return (int)three.pow(exponent).bit_length(); });
+        measure("x^2", n, iterations, [&]() { return (int)half.pow(2).bit_length(); });
+    }
+    std::cout << std::endl;
+}
+
+// Операции со встроенными целыми (ядра для одного блока): инкремент, умножение и деление
+// на месте, остаток и сравнение; размер - в блоках
+static void run_integer_suite() {
+    const size_t sizes[] = { 1, 16, 256, 4096, 100000 };
+    const size_t parts_per_limb = BIGINT_LIMB_BITS / 32;
+
+    begin_group("integer", "limbs", "Встроенные целые, блоки по " + std::to_string(BIGINT_LIMB_BITS) + " бит");
+    for (size_t n : sizes) {
+        size_t iterations = 40000000 / (4 * n + 100) + 1;
+        BigInteger a = random_number<BigInteger>(n * parts_per_limb, 1);
+        BigInteger x = a;
+        measure("++", n, iterations * 4, [&]() { return (int)(++x).is_zero(); });
+        measure("*= /=", n, iterations, [&]() {
+            x *= 1000000007;
+            x /= 1000000007;
+            return (int)x.is_zero();
+        });
+        measure("% int", n, iterations, [&]() { return (int)(a % 1000000007).is_zero(); });
+        measure("< int", n, iterations * 4, [&]() { return (int)(a < 1000000007); });
+    }
+    std::cout << std::endl;
+}
+
+// Простые числа: проверка простого (полный тест Baillie - PSW), проверка случайного нечетного
+// (обычно отсекается пробным делением или первым раундом) и поиск следующего простого
+static void run_prime_suite() {
+    const size_t sizes[] = { 64, 256, 512, 1024, 2048 };
+
+    begin_group("prime", "bits", "Простые числа");
+    for (size_t bits : sizes) {
+        size_t iterations = 40000000 / (bits * bits * 4 + 1000) + 1;
+        BigInteger odd = random_number<BigInteger>(bits / 32, 3) | BigInteger(1);
+        BigInteger prime = odd.next_prime();
+        measure("prime", bits, iterations, [&]() { return (int)prime.is_probable_prime(); });
+        measure("odd", bits, iterations, [&]() { return (int)odd.is_probable_prime(); });
+        measure("next_prime", bits, iterations / 8 + 1, [&]() { return (int)odd.next_prime().bit_length(); });
+    }
+    std::cout << std::endl;
+}
+
+// Двоичный формат: запись и чтение одного числа в памяти (сравнить с parse и toString) и
+// чтение из отображенного в память столбцового файла; размер - в блоках
+static void run_binary_suite() {
+    const size_t sizes[] = { 1, 16, 256, 4096, 100000 };
+    const size_t parts_per_limb = BIGINT_LIMB_BITS / 32;
+    const char* path = "bench_columns.bin";
+
+    begin_group("binary", "limbs", "Двоичный формат, блоки по " + std::to_string(BIGINT_LIMB_BITS) + " бит");
+    for (size_t n : sizes) {
+        size_t iterations = 4000000 / (4 * n + 100) + 1;
+        BigInteger a = random_number<BigInteger>(n * parts_per_limb, 1);
+        std::ostringstream record;
+        a.write_binary(record);
+        std::string bytes = record.str();
+        measure("write", n, iterations, [&]() {
+            std::ostringstream os;
+            a.write_binary(os);
+            return (int)os.tellp();
+        });
+        measure("read", n, iterations, [&]() {
+            std::istringstream is(bytes);
+            BigInteger x;
+            BigInteger::read_binary(is, x);
+            return (int)x.bit_length();
+        });
+
+        const size_t rows = 16;
+        ColumnFile file;
+        if (!ColumnFile::write(path, 1, rows, [&](size_t, size_t) -> const BigInteger& { return a; }) || !file.open(path)) {
+            std::cerr << "Не удалось записать " << path << std::endl;
+            continue;
+        }
+        size_t row = 0;
+        measure("view value", n, iterations, [&]() { return (int)file.get(0, row++ % rows).value().bit_length(); });
+    }
+    std::remove(path);
+    std::cout << std::endl;
+}
+
+// Арифметика дробей с числителем и знаменателем из n блоков. Каждая операция сокращает
+// результат (НОД квадратичен), поэтому размеры - до 1024 блоков
+static void run_fraction_suite() {
+    const size_t sizes[] = { 1, 4, 16, 64, 256, 1024 };
+    const size_t parts_per_limb = BIGINT_LIMB_BITS / 32;
+
+    begin_group("fraction", "limbs", "Дроби, блоки по " + std::to_string(BIGINT_LIMB_BITS) + " бит");
+    for (size_t n : sizes) {
+        size_t iterations = 2000000 / (n * n + 100) + 1;
+        size_t parts = n * parts_per_limb;
+        Fraction x(random_number<BigInteger>(parts, 1), random_number<BigInteger>(parts, 2));
+        Fraction y(random_number<BigInteger>(parts, 3), random_number<BigInteger>(parts, 4));
+        measure("+", n, iterations, [&]() { return (x + y).sign(); });
+        measure("-", n, iterations, [&]() { return (x - y).sign(); });
+        measure("*", n, iterations, [&]() { return (x * y).sign(); });
+        measure("/", n, iterations, [&]() { return (x / y).sign(); });
+        measure("<", n, iterations, [&]() { return (int)(x < y); });
+        measure("pow 3", n, iterations, [&]() { return x.pow(3).sign(); });
+        measure("toDouble", n, iterations, [&]() { return (int)(x.toDouble() > 1.0); });
+    }
+    std::cout << std::endl;
+}
+
+// Уровень ядер, на котором идут замеры (BIGINT_CPU=scalar|sse4|avx2|avx512 - замеры на заданном уровне;
+// правильность ядер всех уровней проверяет test_bigint)
+static void print_kernels() {
+    std::cout << "Ядра: " << CpuDispatch::name(CpuDispatch::selected())
+              << " (процессор: " << CpuDispatch::name(CpuDispatch::detected()) << ")" << std::endl << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            std::cerr << "Использование: " << argv[0] << " [--json файл]" << std::endl;
+            return 2;
+        }
+    }
+
+    print_kernels();
+    run_suite<unsigned int>();
+    run_suite<unsigned long long>();
+    run_shift_suite<unsigned int>();
+    run_shift_suite<unsigned long long>();
+    run_io_suite();
+    run_pow_suite();
+    run_integer_suite();
+    run_prime_suite();
+    run_fraction_suite();
+    run_binary_suite();
+    run_batch_suite();
+    run_parallel_suite();
+
+    if (json_path && !write_json(json_path)) {
+        std::cerr << "Не удалось записать " << json_path << std::endl;
+        return 1;
+    }
+    return 0;
+}
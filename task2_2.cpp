@@ -1,214 +1,9 @@
+// Демонстрация класса Fraction.
+// Сборка: g++ -O2 -std=c++17 -pthread task2_2.cpp Fraction.cpp -o task2_2
 #include <iostream>
-#include "Fraction.h"
-#include <algorithm>
-#include <cctype>
 #include <stdexcept>
-#include <sstream>
-#include <string>
-
-// Удаление пробелов из строки
-std::string Fraction::removeSpaces(const std::string& str) {
-    std::string result = str;
-    result.erase(std::remove_if(result.begin(), result.end(), ::isspace), result.end());
-    return result;
-}
-
-// Нахождение НОД двух чисел
-BigInteger Fraction::gcd(BigInteger a, BigInteger b) {
-    if (a == 0 && b == 0) return BigInteger(1);
-    if (a < BigInteger(0)) a = BigInteger(0) - a;
-    if (b < BigInteger(0)) b = BigInteger(0) - b;
-    while (b != BigInteger(0)) {
-        BigInteger temp = b;
-        b = a % b;
-        a = temp;
-    }
-    return a;
-}
-
-// Нормализация дроби
-void Fraction::normalize() {
-    if (denominator == BigInteger(0))
-        throw std::runtime_error("Denominator cannot be zero");
-    if (denominator < BigInteger(0)) {
-        numerator = BigInteger(0) - numerator;
-        denominator = BigInteger(0) - denominator;
-    }
-    BigInteger common_divisor = gcd(numerator, denominator);
-    if (common_divisor > BigInteger(1)) {
-        numerator = numerator / common_divisor;
-        denominator = denominator / common_divisor;
-    }
-    if (numerator == BigInteger(0)) denominator = BigInteger(1);
-}
-
-// Конструкторы
-Fraction::Fraction() : numerator(0), denominator(1) {}
-
-Fraction::Fraction(const BigInteger& num, const BigInteger& denom)
-    : numerator(num), denominator(denom) { normalize(); }
-
-Fraction::Fraction(int num, int denom)
-    : numerator(num), denominator(denom) { normalize(); }
-
-Fraction::Fraction(int num)
-    : numerator(num), denominator(1) {}
-
-Fraction::Fraction(const std::string& str) {
-    std::string clean_str = removeSpaces(str);
-    size_t slash_pos = clean_str.find('/');
-    if (slash_pos == std::string::npos) {
-        numerator = BigInteger(clean_str);
-        denominator = BigInteger(1);
-    } else {
-        numerator = BigInteger(clean_str.substr(0, slash_pos));
-        denominator = BigInteger(clean_str.substr(slash_pos + 1));
-    }
-    normalize();
-}
-
-// Геттеры
-const BigInteger& Fraction::getNumerator() const { return numerator; }
-const BigInteger& Fraction::getDenominator() const { return denominator; }
-
-// Проверка на ноль
-bool Fraction::isZero() const { return numerator == BigInteger(0); }
-
-// Получение знака дроби
-int Fraction::sign() const {
-    if (numerator == BigInteger(0)) return 0;
-    return (numerator < BigInteger(0)) ? -1 : 1;
-}
-
-// Арифметические операции
-Fraction Fraction::operator-() const {
-    return Fraction(BigInteger(0) - numerator, denominator);
-}
-
-Fraction& Fraction::operator+=(const Fraction& other) {
-    numerator = numerator * other.denominator + other.numerator * denominator;
-    denominator = denominator * other.denominator;
-    normalize();
-    return *this;
-}
-
-Fraction Fraction::operator+(const Fraction& other) const {
-    Fraction result = *this;
-    result += other;
-    return result;
-}
-
-Fraction& Fraction::operator-=(const Fraction& other) {
-    numerator = numerator * other.denominator - other.numerator * denominator;
-    denominator = denominator * other.denominator;
-    normalize();
-    return *this;
-}
-
-Fraction Fraction::operator-(const Fraction& other) const {
-    Fraction result = *this;
-    result -= other;
-    return result;
-}
-
-Fraction& Fraction::operator*=(const Fraction& other) {
-    numerator = numerator * other.numerator;
-    denominator = denominator * other.denominator;
-    normalize();
-    return *this;
-}
-
-Fraction Fraction::operator*(const Fraction& other) const {
-    Fraction result = *this;
-    result *= other;
-    return result;
-}
-
-Fraction& Fraction::operator/=(const Fraction& other) {
-    if (other.numerator == BigInteger(0))
-        throw std::runtime_error("Division by zero");
-    numerator = numerator * other.denominator;
-    denominator = denominator * other.numerator;
-    normalize();
-    return *this;
-}
-
-Fraction Fraction::operator/(const Fraction& other) const {
-    Fraction result = *this;
-    result /= other;
-    return result;
-}
-
-// Операторы сравнения
-bool Fraction::operator==(const Fraction& other) const {
-    return numerator == other.numerator && denominator == other.denominator;
-}
-
-bool Fraction::operator!=(const Fraction& other) const {
-    return !(*this == other);
-}
-
-bool Fraction::operator<(const Fraction& other) const {
-    return (numerator * other.denominator) < (other.numerator * denominator);
-}
-
-bool Fraction::operator<=(const Fraction& other) const {
-    return *this < other || *this == other;
-}
-
-bool Fraction::operator>(const Fraction& other) const {
-    return !(*this <= other);
-}
-
-bool Fraction::operator>=(const Fraction& other) const {
-    return !(*this < other);
-}
-
-// Возведение в степень
-Fraction Fraction::pow(unsigned int exponent) const {
-    Fraction result(1);
-    for (unsigned int i = 0; i < exponent; ++i)
-        result *= *this;
-    return result;
-}
-
-// Модуль дроби
-Fraction Fraction::abs() const {
-    if (numerator < BigInteger(0))
-        return Fraction(BigInteger(0) - numerator, denominator);
-    return *this;
-}
-
-// Преобразование в double
-double Fraction::toDouble() const {
-    std::string num_str = numerator.toString();
-    std::string den_str = denominator.toString();
-    return std::stod(num_str) / std::stod(den_str);
-}
-
-// Преобразование в строку
-std::string Fraction::toString() const {
-    std::ostringstream oss;
-    if (denominator == BigInteger(1)) {
-        oss << numerator;
-    } else {
-        oss << numerator << "/" << denominator;
-    }
-    return oss.str();
-}
-
-// Операторы ввода/вывода
-std::ostream& operator<<(std::ostream& os, const Fraction& f) {
-    os << f.toString();
-    return os;
-}
+#include "Fraction.h"
 
-std::istream& operator>>(std::istream& is, Fraction& f) {
-    std::string str;
-    is >> str;
-    f = Fraction(str);
-    return is;
-}
 int main() {
     try {
         Fraction f1(1, 2);
@@ -241,6 +36,17 @@ int main() {
         std::cout << "f3.abs() = " << f3.abs() << std::endl;
         std::cout << "f3.pow(3) = " << f3.pow(3) << std::endl;
         std::cout << "f4.toDouble() = " << f4.toDouble() << std::endl;
+        // Числитель и знаменатель вне диапазона double, отношение - в нем
+        Fraction huge(BigInteger(3).pow(5000), BigInteger(2).pow(7900));
+        std::cout << "(3^5000 / 2^7900).toDouble() = " << huge.toDouble() << std::endl;
+
+        // Длинное накопление: сумма 1/k^2 в обычном и ленивом режимах
+        Fraction eager_sum, lazy_sum;
+        for (int k = 1; k <= 100; ++k) eager_sum += Fraction(1, k * k);
+        lazy_sum.setLazyNormalization(true);
+        for (int k = 1; k <= 100; ++k) lazy_sum += Fraction(1, k * k);
+        std::cout << "sum 1/k^2 (k <= 100) = " << eager_sum.toDouble()
+                  << (eager_sum == lazy_sum ? " (ленивый режим совпадает)" : " (ленивый режим расходится)") << std::endl;
 
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,768 @@
+// Проверки BigInteger: результаты сравниваются с эталонными вычислениями на встроенных целых.
+// Сборка: g++ -O2 -std=c++17 -pthread test_bigint.cpp -o test_bigint
+// (для 32-битных блоков добавить -DBIGINT_LIMB_BITS=32).
+// Запуск: test_bigint - код возврата 0, если все проверки прошли
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "BigInteger.h"
+
+// Пороги алгоритмов для блоков типа BigInteger
+#if BIGINT_LIMB_BITS == 32
+typedef LimbTraits<unsigned int> Traits;
+#else
+typedef LimbTraits<unsigned long long> Traits;
+#endif
+
+// --- Учет проверок ---
+static size_t checks = 0;
+static size_t failures = 0;
+
+// Одна проверка; описания первых ошибок печатаются
+static void check(bool ok, const std::string& what) {
+    ++checks;
+    if (ok) return;
+    if (++failures <= 20) std::cout << "  ОШИБКА: " << what << std::endl;
+}
+
+// --- Эталонные функции на встроенных целых ---
+
+// base^n, или -1, если модуль результата больше 2^63 - 1
+static long long ref_pow(long long base, unsigned int n) {
+    __int128 result = 1;
+    for (unsigned int i = 0; i < n; ++i) {
+        result *= base;
+        if (result > LLONG_MAX || result < -LLONG_MAX) return -1;
+    }
+    return (long long)result;
+}
+
+// floor(|x|^(1/n)) со знаком x (двоичный поиск); n >= 1, при x < 0 n нечетно
+static long long ref_iroot(long long x, unsigned int n) {
+    unsigned long long magnitude = x < 0 ? 0ull - (unsigned long long)x : (unsigned long long)x;
+    unsigned long long low = 0, high = magnitude < 2 ? magnitude : (n == 1 ? magnitude : 1ull << (64 / n + 1));
+    while (low < high) { // Наибольшее r с r^n <= magnitude
+        unsigned long long middle = low + (high - low + 1) / 2;
+        unsigned __int128 power = 1;
+        for (unsigned int i = 0; i < n && power <= magnitude; ++i) power *= middle;
+        if (power <= magnitude) low = middle;
+        else high = middle - 1;
+    }
+    return x < 0 ? -(long long)low : (long long)low;
+}
+
+// Разложение x = base^exponent с наибольшим показателем (у отрицательных - нечетным) по перебору
+static bool ref_perfect_power(long long x, long long& base, unsigned int& exponent) {
+    if (x == 0 || x == 1) { base = x; exponent = 2; return true; }
+    if (x == -1) { base = -1; exponent = 3; return true; }
+    for (unsigned int e = 63; e >= 2; --e) {
+        if (x < 0 && e % 2 == 0) continue;
+        long long r = ref_iroot(x, e);
+        if (ref_pow(r, e) == x) { base = r; exponent = e; return true; }
+    }
+    base = x;
+    exponent = 1;
+    return false;
+}
+
+// Число 64-битных слов, покрывающих limbs блоков
+static size_t words_for_limbs(size_t limbs) {
+    return (limbs * BIGINT_LIMB_BITS + 63) / 64;
+}
+
+// Псевдослучайные числа (splitmix64): проверки воспроизводимы от запуска к запуску
+struct Random {
+    unsigned long long state;
+
+    explicit Random(unsigned long long seed) : state(seed) {}
+
+    unsigned long long next() {
+        unsigned long long z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Число ровно из words 64-битных слов (старшее слово не 0)
+    BigInteger number(size_t words, bool negative = false) {
+        std::vector<unsigned char> bytes(8 * words);
+        for (size_t i = 0; i < words; ++i) {
+            unsigned long long word = next();
+            if (i + 1 == words && word == 0) word = 1;
+            BinaryFormat::store(&bytes[8 * i], word);
+        }
+        return BigInteger::from_words(bytes.data(), words, negative);
+    }
+
+    // Положительное число ровно из count блоков
+    BigInteger limbs(size_t count) {
+        size_t bits = count * BIGINT_LIMB_BITS;
+        BigInteger x = number(words_for_limbs(count)) >> (int)(64 * words_for_limbs(count) - bits);
+        return x | (BigInteger(1) << (int)(bits - 1));
+    }
+};
+
+static std::string describe(const char* what, long long x, unsigned int n) {
+    std::ostringstream oss;
+    oss << what << "(" << x << ", " << n << ")";
+    return oss.str();
+}
+
+// --- Корни и точные степени ---
+
+static void check_root(long long x, unsigned int n) {
+    BigInteger value(x);
+    check(value.iroot(n) == ref_iroot(x, n), describe("iroot", x, n));
+}
+
+static void check_perfect_power(long long x) {
+    long long expected_base;
+    unsigned int expected_exponent;
+    bool expected = ref_perfect_power(x, expected_base, expected_exponent);
+    BigInteger base;
+    unsigned int exponent;
+    bool found = BigInteger(x).is_perfect_power(base, exponent);
+    check(found == expected && base == expected_base && exponent == expected_exponent &&
+              BigInteger(x).is_perfect_power() == expected,
+          describe("is_perfect_power", x, expected_exponent));
+}
+
+static void run_root_tests() {
+    std::cout << "Корни и точные степени" << std::endl;
+
+    // Подряд все малые значения: isqrt на [0, 2^17], корни степеней 2..7 (нечетных - и отрицательных)
+    for (long long x = -4; x <= (1 << 17); ++x) {
+        long long expected = x < 0 ? 0 : ref_iroot(x, 2);
+        check(BigInteger(x).isqrt() == expected, describe("isqrt", x, 2));
+    }
+    for (unsigned int n = 1; n <= 7; ++n) {
+        for (long long x = -30000; x <= 30000; ++x) {
+            if (x < 0 && n % 2 == 0) {
+                check(BigInteger(x).iroot(n) == 0, describe("iroot", x, n));
+            } else {
+                check_root(x, n);
+            }
+        }
+    }
+    check(BigInteger(12345).iroot(0) == 0, "iroot(12345, 0)");
+
+    // Окрестности точных степеней r^n до 2^63: переход через 40 бит (оценка в double)
+    // и длинные корни через удвоение точности
+    for (unsigned int n = 2; n <= 40; ++n) {
+        for (long long r = 2; ref_pow(r, n) > 0; r = r < 64 ? r + 1 : r + r / 3) {
+            long long power = ref_pow(r, n);
+            for (long long delta = -1; delta <= 1; ++delta) {
+                if (power + delta > 0 && (delta <= 0 || power < LLONG_MAX)) {
+                    check_root(power + delta, n);
+                    if (n % 2 == 1) check_root(-(power + delta), n);
+                }
+            }
+        }
+    }
+
+    // Точные степени за пределами 64 бит: iroot(r^n) = r, iroot(r^n - 1) = r - 1
+    BigInteger r("123456789012345678901234567");
+    for (unsigned int n = 2; n <= 9; ++n) {
+        BigInteger power = r.pow(n);
+        check(power.iroot(n) == r && (power - 1).iroot(n) == r - 1 && (power + 1).iroot(n) == r,
+              describe("iroot(r^n +- 1)", 0, n));
+        BigInteger base;
+        unsigned int exponent;
+        check(power.is_perfect_power(base, exponent) && base == r && exponent == n,
+              describe("is_perfect_power(r^n)", 0, n));
+        check(!(power + 1).is_perfect_power(), describe("is_perfect_power(r^n + 1)", 0, n));
+        if (n % 2 == 1) check((-power).iroot(n) == -r, describe("iroot(-r^n)", 0, n));
+    }
+
+    // Корни длиной 36..62 бит из степеней за пределами 64 бит (граница оценки корня в double)
+    for (unsigned int k = 36; k <= 62; ++k) {
+        for (unsigned int n = 2; n <= 5; ++n) {
+            BigInteger root = (BigInteger(1) << (int)k) + (long long)(k * 7919 + n);
+            BigInteger power = root.pow(n);
+            BigInteger base;
+            unsigned int exponent;
+            bool found = power.is_perfect_power(base, exponent);
+            check(found && exponent % n == 0 && base.pow(exponent) == power,
+                  describe("is_perfect_power(r^n), бит в r и n", k, n));
+            check(power.iroot(n) == root && (power - 1).iroot(n) == root - 1,
+                  describe("iroot(r^n), бит в r и n", k, n));
+        }
+    }
+
+    // Точные степени: все значения подряд и степени до 2^63 с соседями
+    for (long long x = -70000; x <= 300000; ++x) check_perfect_power(x);
+    for (unsigned int n = 2; n <= 62; ++n) {
+        for (long long b = 2; ref_pow(b, n) > 0; b = b < 300 ? b + 1 : b + b / 7) {
+            long long power = ref_pow(b, n);
+            check_perfect_power(power);
+            check_perfect_power(power - 1);
+            if (power < LLONG_MAX) check_perfect_power(power + 1);
+            check_perfect_power(-power);
+        }
+    }
+}
+
+// --- Двоичный формат ---
+
+// Чтение записи из строки; исключение считается ошибкой
+static bool read_record(const std::string& bytes, BigInteger& out, const std::string& what) {
+    std::istringstream is(bytes);
+    try {
+        return BigInteger::read_binary(is, out);
+    } catch (const std::exception& e) {
+        check(false, what + ": исключение " + e.what());
+        return false;
+    }
+}
+
+// Запись с заданным словом размера и знака, за которой идут payload_words нулевых слов
+static std::string forged_record(unsigned long long size_word, size_t payload_words) {
+    std::string bytes(8 * (payload_words + 1), '\0');
+    BinaryFormat::store(&bytes[0], size_word);
+    return bytes;
+}
+
+static void run_binary_tests() {
+    std::cout << "Двоичный формат" << std::endl;
+
+    // Запись и чтение, в том числе числа длиннее одного куска чтения
+    BigInteger long_value = (BigInteger(1) << (int)(64 * (BinaryFormat::READ_CHUNK_WORDS * 2 + 3))) - 12345;
+    const BigInteger values[] = { BigInteger(0), BigInteger(1), BigInteger(-1), BigInteger(LLONG_MIN),
+                                  BigInteger("-123456789012345678901234567890123456789"), long_value, -long_value };
+    for (const BigInteger& value : values) {
+        std::ostringstream os;
+        value.write_binary(os);
+        BigInteger read(777);
+        std::ostringstream what;
+        what << "запись и чтение числа из " << value.bit_length() << " бит со знаком " << value.sign();
+        check(read_record(os.str(), read, what.str()) && read == value, what.str());
+
+        // Обрезанная запись: конец в слове размера, в начале, середине и конце модуля
+        std::string bytes = os.str();
+        size_t cuts[] = { 3, 8 + 1, bytes.size() / 2, bytes.size() - 1 };
+        for (size_t cut : cuts) {
+            if (cut >= bytes.size() || (value.is_zero() && cut >= 8)) continue;
+            std::ostringstream cut_what;
+            cut_what << "обрезанная запись (" << cut << " из " << bytes.size() << " байт)";
+            check(!read_record(bytes.substr(0, cut), read, cut_what.str()), cut_what.str());
+        }
+    }
+
+    // Слово размера обещает гигабайты и больше, данных в потоке - несколько слов:
+    // false без исключения и без выделения памяти под заявленный размер
+    const unsigned long long huge_sizes[] = { 1ull << 30, 1ull << 32, 1ull << 40, 1ull << 58, (1ull << 62) - 1,
+                                              ~0ull >> 1 };
+    for (unsigned long long words : huge_sizes) {
+        for (int negative = 0; negative <= 1; ++negative) {
+            std::ostringstream what;
+            what << "слово размера " << words << " слов";
+            BigInteger read;
+            check(!read_record(forged_record(words << 1 | (unsigned long long)negative, 4), read, what.str()),
+                  what.str());
+        }
+    }
+
+    // Столбцовый файл с обнуленным старшим словом последнего модуля: open отказывает
+    // (иначе ненулевой по размеру модуль читался бы как 0)
+    const char* path = "test_bigint_columns.tmp";
+    BigInteger cells[2][2] = { { BigInteger(1), BigInteger(3) }, { BigInteger(2), BigInteger("1000000000000000000000007") } };
+    bool written = ColumnFile::write(path, 2, 2, [&cells](size_t column, size_t row) -> const BigInteger& {
+        return cells[column][row];
+    });
+    ColumnFile file;
+    check(written && file.open(path) && file.get(1, 1).value() == cells[1][1], "столбцовый файл: запись и чтение");
+    file.close();
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    if (bytes.size() >= 8) bytes.replace(bytes.size() - 8, 8, 8, '\0');
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size());
+    }
+    check(!file.open(path), "столбцовый файл с нулевым старшим словом модуля");
+    std::remove(path);
+
+    // bit_length у view с ведущими нулевыми словами
+    unsigned char words[24] = {};
+    BinaryFormat::store(words, 5);
+    BigIntegerView view = { words, 3, false };
+    check(view.bit_length() == 3, "BigIntegerView::bit_length с ведущими нулями");
+    view.size = 0;
+    check(view.bit_length() == 0, "BigIntegerView::bit_length у нуля");
+}
+
+// --- Параллельные пути умножения и деления ---
+
+// Произведение, частное и остаток не зависят от числа потоков пула; деление обращает умножение
+static void check_parallel_case(const char* what, Random& random, size_t a_words, size_t b_words) {
+    BigInteger a = random.number(a_words, true), b = random.number(b_words);
+    BigInteger shift = random.number(b_words - 1); // 0 < shift < |b|
+    BigInteger product[2], quotient[2], remainder[2], shifted_quotient[2], shifted_remainder[2];
+    const size_t threads[2] = { 1, 4 };
+    for (int i = 0; i < 2; ++i) {
+        WorkerPool::instance().set_threads(threads[i]);
+        product[i] = a * b;
+        quotient[i] = product[i] / b;
+        remainder[i] = product[i] % b;
+        BigInteger::divmod(product[i] - shift, b, shifted_quotient[i], shifted_remainder[i]);
+    }
+    WorkerPool::instance().set_threads(0);
+
+    std::ostringstream oss;
+    oss << what << " (" << a_words << " и " << b_words << " слов)";
+    std::string label = oss.str();
+    check(product[0] == product[1], label + ": произведение при 1 и 4 потоках");
+    check(quotient[0] == quotient[1] && remainder[0] == remainder[1], label + ": частное и остаток при 1 и 4 потоках");
+    check(shifted_quotient[0] == shifted_quotient[1] && shifted_remainder[0] == shifted_remainder[1],
+          label + ": divmod при 1 и 4 потоках");
+    check(quotient[0] == a && remainder[0].is_zero(), label + ": (a*b)/b == a, (a*b)%b == 0");
+    // a < 0: частное округляется к нулю, остаток со знаком делимого
+    check(shifted_quotient[0] == a && shifted_remainder[0] == -shift, label + ": (a*b - c)/b == a, (a*b - c)%b == -c");
+}
+
+static void run_parallel_tests() {
+    std::cout << "Параллельные умножение и деление" << std::endl;
+    Random random(16);
+    size_t parallel = words_for_limbs(Traits::parallel_threshold), ntt = words_for_limbs(Traits::ntt_threshold);
+    size_t div_dc = words_for_limbs(Traits::div_dc_threshold);
+    check_parallel_case("NTT", random, ntt + 100, ntt + 10);
+    check_parallel_case("NTT, разные длины", random, 3 * ntt, ntt + 1);
+    check_parallel_case("Toom-3 с задачами в пуле", random, parallel + 50, parallel + 50);
+    check_parallel_case("несбалансированное по кускам", random, 5 * parallel, parallel + 1);
+    check_parallel_case("рекурсивное деление", random, 4 * div_dc, 2 * div_dc);
+}
+
+// --- Деление ---
+
+static BigInteger magnitude(const BigInteger& x) {
+    return x.sign() < 0 ? -x : x;
+}
+
+// a = q * b + r, |r| < |b|, знак остатка - знак делимого; операторы / и % совпадают с divmod
+static void check_division(const BigInteger& a, const BigInteger& b, const char* what) {
+    BigInteger q, r;
+    BigInteger::divmod(a, b, q, r);
+    bool ok = q * b + r == a && magnitude(r) < magnitude(b) && (r.is_zero() || r.sign() == a.sign()) &&
+              a / b == q && a % b == r;
+    std::ostringstream oss;
+    oss << what << ": делимое " << a.bit_length() << " бит, делитель " << b.bit_length() << " бит, знаки "
+        << a.sign() << " и " << b.sign();
+    check(ok, oss.str());
+}
+
+// То же для делителя - встроенного целого (один блок - однопроходный divmod_1)
+static void check_integer_division(const BigInteger& a, long long d) {
+    BigInteger q = a / d, r = a % d, b(d);
+    BigInteger q_assigned = a, r_assigned = a;
+    q_assigned /= d;
+    r_assigned %= d;
+    bool ok = q * b + r == a && magnitude(r) < magnitude(b) && (r.is_zero() || r.sign() == a.sign()) &&
+              q_assigned == q && r_assigned == r;
+    std::ostringstream oss;
+    oss << "деление на " << d << ": делимое " << a.bit_length() << " бит со знаком " << a.sign();
+    check(ok, oss.str());
+}
+
+// Все сочетания знаков делимого и делителя
+static void check_division_signs(const BigInteger& a, const BigInteger& b, const char* what) {
+    check_division(a, b, what);
+    check_division(-a, b, what);
+    check_division(a, -b, what);
+    check_division(-a, -b, what);
+}
+
+static void run_division_tests() {
+    std::cout << "Деление с остатком" << std::endl;
+    Random random(2);
+    size_t div_dc = words_for_limbs(Traits::div_dc_threshold);
+
+    // Случайные длины: "столбик" Кнута (алгоритм D) и рекурсивное деление
+    for (int i = 0; i < 400; ++i) {
+        size_t a_words = 1 + random.next() % (3 * div_dc);
+        size_t b_words = 1 + random.next() % a_words;
+        check_division_signs(random.number(a_words), random.number(b_words), "случайные числа");
+    }
+
+    // Старший блок делителя 100...0: оценка цифры частного на границе, делимые b*k - 1, b*k и b*k + b - 1
+    const int LIMB = BIGINT_LIMB_BITS;
+    const size_t divisor_limbs[] = { 1, 2, 3, 5, Traits::div_dc_threshold, 2 * Traits::div_dc_threshold + 1 };
+    const size_t quotient_limbs[] = { 1, 2, 4, Traits::div_dc_threshold + 3 };
+    for (size_t n : divisor_limbs) {
+        BigInteger top = BigInteger(1) << (int)(n * LIMB - 1);
+        BigInteger below_top = (BigInteger(1) << (int)((n - 1) * LIMB)) - 1;
+        BigInteger divisors[] = { top, top + below_top, top + (random.limbs(n) >> (LIMB + 1)) };
+        for (const BigInteger& b : divisors) {
+            for (size_t m : quotient_limbs) {
+                BigInteger multipliers[] = { (BigInteger(1) << (int)(m * LIMB)) - 1, BigInteger(1) << (int)(m * LIMB - 1),
+                                             random.limbs(m) };
+                for (const BigInteger& k : multipliers) {
+                    check_division_signs(b * k - 1, b, "делитель 100...0, b*k - 1");
+                    check_division_signs(b * k, b, "делитель 100...0, b*k");
+                    check_division_signs(b * k + b - 1, b, "делитель 100...0, b*k + b - 1");
+                }
+            }
+        }
+    }
+
+    // Делитель из одного блока и встроенные целые
+    const long long integer_divisors[] = { 1, -1, 3, -7, 1000000007, (long long)1 << 31, -((long long)1 << 31),
+                                           0xFFFFFFFFll, (long long)1 << 32, LLONG_MAX, LLONG_MIN,
+                                           LLONG_MIN + 1, 0x123456789ABCDEFll };
+    for (int i = 0; i < 40; ++i) {
+        BigInteger a = random.number(1 + random.next() % 20, i % 2 != 0);
+        for (long long d : integer_divisors) {
+            check_integer_division(a, d);
+            check_division_signs(a, BigInteger(d), "делитель из одного блока");
+        }
+        check_integer_division(a, (long long)(random.next() >> 1) * (i % 4 < 2 ? 1 : -1));
+    }
+}
+
+// --- Побитовые операции ---
+
+// Число в дополнительном коде по 64-битным словам: младшие без знака, последнее - со знаком
+struct TwosComplement {
+    std::vector<unsigned long long> words;
+
+    // Слово i с расширением знака за пределами words
+    unsigned long long word(size_t i) const {
+        if (i < words.size()) return words[i];
+        return (long long)words.back() < 0 ? ~0ull : 0;
+    }
+
+    BigInteger value() const {
+        size_t low = words.size() - 1;
+        std::vector<unsigned char> bytes(8 * low + 8);
+        for (size_t i = 0; i < low; ++i) BinaryFormat::store(&bytes[8 * i], words[i]);
+        return BigInteger::from_words(bytes.data(), low, false) + (BigInteger((long long)words.back()) << (int)(64 * low));
+    }
+};
+
+// Пословная операция над дополнительными кодами (эталон для & | ^)
+template <typename Op>
+static BigInteger ref_bitwise(const TwosComplement& a, const TwosComplement& b, Op op) {
+    TwosComplement result;
+    size_t n = a.words.size() > b.words.size() ? a.words.size() : b.words.size();
+    for (size_t i = 0; i < n; ++i) result.words.push_back(op(a.word(i), b.word(i)));
+    return result.value();
+}
+
+// Слова с нулями, единицами и границами знака: у отрицательных чисел с нулевыми младшими словами
+// модуль кратен 2^64 и заем при переходе к дополнительному коду проходит через нулевые блоки
+static TwosComplement random_twos(Random& random, size_t words) {
+    const unsigned long long patterns[] = { 0, 1, ~0ull, 1ull << 63, (1ull << 63) - 1, 1ull << 32, 0xFFFFFFFFull };
+    TwosComplement x;
+    for (size_t i = 0; i < words; ++i) {
+        unsigned long long choice = random.next() % 10;
+        x.words.push_back(choice < 7 ? patterns[choice] : random.next());
+    }
+    return x;
+}
+
+static void check_bitwise(const TwosComplement& a, const TwosComplement& b) {
+    BigInteger x = a.value(), y = b.value();
+    BigInteger expected_and = ref_bitwise(a, b, [](unsigned long long p, unsigned long long q) { return p & q; });
+    BigInteger expected_or = ref_bitwise(a, b, [](unsigned long long p, unsigned long long q) { return p | q; });
+    BigInteger expected_xor = ref_bitwise(a, b, [](unsigned long long p, unsigned long long q) { return p ^ q; });
+    BigInteger expected_not = ref_bitwise(a, a, [](unsigned long long p, unsigned long long) { return ~p; });
+    BigInteger x_and = x, x_or = x, x_xor = x;
+    x_and &= y;
+    x_or |= y;
+    x_xor ^= y;
+    bool ok = (x & y) == expected_and && (BigInteger(x) & y) == expected_and && x_and == expected_and &&
+              (x | y) == expected_or && (BigInteger(x) | y) == expected_or && x_or == expected_or &&
+              (x ^ y) == expected_xor && (BigInteger(x) ^ y) == expected_xor && x_xor == expected_xor &&
+              ~x == expected_not && ~BigInteger(x) == expected_not;
+    if (ok) {
+        check(true, "");
+        return;
+    }
+    std::ostringstream oss;
+    oss << "побитовые операции: " << x << " и " << y;
+    check(false, oss.str());
+}
+
+static void run_bitwise_tests() {
+    std::cout << "Побитовые операции" << std::endl;
+
+    // Одно слово: эталон - встроенные long long (в том числе small_value и его границы)
+    const long long values[] = { 0, 1, -1, 2, -2, 255, -256, LLONG_MAX, LLONG_MIN, LLONG_MIN + 1,
+                                 (long long)1 << 32, -((long long)1 << 32), 0x5555555555555555ll };
+    for (long long a : values) {
+        for (long long b : values) {
+            std::ostringstream oss;
+            oss << "побитовые операции: " << a << " и " << b;
+            check((BigInteger(a) & BigInteger(b)) == (a & b) && (BigInteger(a) | BigInteger(b)) == (a | b) &&
+                  (BigInteger(a) ^ BigInteger(b)) == (a ^ b) && ~BigInteger(a) == ~a, oss.str());
+        }
+    }
+
+    // Числа, кратные 2^64 и 2^128, с обоими знаками
+    const TwosComplement multiples[] = { { { 0, ~0ull } }, { { 0, 0, ~0ull } }, { { 0, 0, (unsigned long long)-3 } },
+                                         { { 0, 1 } }, { { 0, 1ull << 63 } }, { { 0, 0, 1ull << 63 } },
+                                         { { 5, ~0ull } }, { { ~0ull } }, { { 1 } } };
+    for (const TwosComplement& a : multiples) {
+        for (const TwosComplement& b : multiples) check_bitwise(a, b);
+    }
+
+    // Случайные числа из 1-5 слов со смешанными знаками
+    Random random(17);
+    for (int i = 0; i < 3000; ++i) {
+        check_bitwise(random_twos(random, 1 + random.next() % 5), random_twos(random, 1 + random.next() % 5));
+    }
+}
+
+// --- Модульная арифметика ---
+
+// Вычет x по модулю |m| в [0, |m|) через обычные % и сложение
+static BigInteger ref_mod(const BigInteger& x, const BigInteger& m) {
+    BigInteger r = x % m;
+    return r.sign() < 0 ? r + magnitude(m) : r;
+}
+
+// base^exponent mod |m| бинарным возведением на обычных умножении и %
+static BigInteger ref_powmod(const BigInteger& base, const BigInteger& exponent, const BigInteger& m) {
+    BigInteger result = ref_mod(BigInteger(1), m), b = ref_mod(base, m);
+    for (size_t i = exponent.bit_length(); i-- > 0;) {
+        result = ref_mod(result * result, m);
+        if ((exponent >> (int)i) % 2 != 0) result = ref_mod(result * b, m);
+    }
+    return result;
+}
+
+// powmod, ModContext::pow, mul и reduce против эталона на обычных операциях
+static void check_modular(const BigInteger& base, const BigInteger& exponent, const BigInteger& m, const char* what) {
+    BigInteger::ModContext context(m);
+    BigInteger expected = ref_powmod(base, exponent, m);
+    BigInteger other = base + exponent; // Второй множитель для mul
+    bool ok = BigInteger::powmod(base, exponent, m) == expected && context.pow(base, exponent) == expected &&
+              context.mul(base, other) == ref_mod(base * other, m) && context.reduce(base) == ref_mod(base, m);
+    std::ostringstream oss;
+    oss << what << ": основание " << base.bit_length() << " бит со знаком " << base.sign() << ", показатель "
+        << exponent.bit_length() << " бит, модуль " << m.bit_length() << " бит ("
+        << ((m % 2 != 0) ? "Монтгомери" : "Барретт") << ")";
+    check(ok, oss.str());
+}
+
+static void run_modular_tests() {
+    std::cout << "Модульная арифметика" << std::endl;
+
+    // Малые значения подряд: повторное умножение, показатель 0, модуль 1, отрицательные основания
+    size_t mismatches = 0;
+    for (long long m = 1; m <= 40; ++m) {
+        BigInteger::ModContext context((BigInteger(m)));
+        for (long long base = -20; base <= 20; ++base) {
+            long long expected = ((1 % m) + m) % m;
+            for (long long e = 0; e <= 12; ++e) {
+                bool ok = BigInteger::powmod(BigInteger(base), BigInteger(e), BigInteger(m)) == expected &&
+                          context.pow(BigInteger(base), BigInteger(e)) == expected &&
+                          BigInteger::powmod(BigInteger(base), BigInteger(e), BigInteger(-m)) == expected;
+                if (!ok && mismatches++ == 0) {
+                    std::ostringstream oss;
+                    oss << "powmod(" << base << ", " << e << ", " << m << ") != " << expected;
+                    check(false, oss.str());
+                }
+                expected = ((expected * base) % m + m) % m;
+            }
+        }
+    }
+    check(mismatches == 0, "powmod на малых значениях");
+    check(BigInteger::powmod(BigInteger(5), BigInteger(-3), BigInteger(7)) == 0, "powmod с отрицательным показателем");
+    check(BigInteger::powmod(BigInteger(5), BigInteger(3), BigInteger(0)) == 0, "powmod по модулю 0");
+
+    // Многоблочные нечетные (Монтгомери) и четные (Барретт) модули, в том числе от TOOM3_THRESHOLD блоков
+    Random random(8);
+    const size_t modulus_limbs[] = { 1, 2, 3, 7, 33, Traits::toom3_threshold, Traits::toom3_threshold + 5 };
+    for (size_t n : modulus_limbs) {
+        for (int parity = 0; parity <= 1; ++parity) {
+            BigInteger m = random.limbs(n);
+            if ((m % 2 != 0) != (parity != 0)) m += 1;
+            const char* what = parity ? "нечетный модуль" : "четный модуль";
+            size_t exponent_words = n >= Traits::toom3_threshold ? 1 : 3;
+            BigInteger exponents[] = { BigInteger(0), BigInteger(1), BigInteger(2), random.number(exponent_words) };
+            for (const BigInteger& e : exponents) {
+                check_modular(random.number(words_for_limbs(n) + 1), e, m, what);
+                check_modular(-random.number(words_for_limbs(n)), e, m, what);
+                check_modular(m - 1, e, -m, what);
+                check_modular(BigInteger(0), e, m, what);
+            }
+        }
+    }
+    check_modular(random.number(3, true), random.number(2), BigInteger(1), "модуль 1");
+    check_modular(random.number(3, true), BigInteger(0), BigInteger(-1), "модуль -1, показатель 0");
+}
+
+// --- Простые числа ---
+
+// Составное n, проходящее сильный тест по основанию 2, is_probable_prime должна отвергнуть
+static void check_strong_pseudoprime(const BigInteger& n, const char* what) {
+    check(n.bit_length() <= 64 || BigInteger::ModContext(n).strong_probable_prime(BigInteger(2)),
+          std::string(what) + ": проходит сильный тест по основанию 2");
+    check(!n.is_probable_prime(), std::string(what) + ": отвергнуто is_probable_prime");
+}
+
+// next_prime при 1 и 4 потоках: одно и то же простое, между x и ним простых нет
+static void check_next_prime(const BigInteger& x, const char* what) {
+    WorkerPool::instance().set_threads(1);
+    BigInteger sequential = x.next_prime();
+    WorkerPool::instance().set_threads(4);
+    BigInteger parallel = x.next_prime();
+    WorkerPool::instance().set_threads(0);
+
+    bool gap_clear = true;
+    for (BigInteger candidate = x + 1; gap_clear && candidate < sequential; ++candidate) {
+        gap_clear = !candidate.is_probable_prime();
+    }
+    std::ostringstream oss;
+    oss << what << " (" << x.bit_length() << " бит)";
+    check(sequential == parallel, oss.str() + ": next_prime при 1 и 4 потоках");
+    check(sequential > x && sequential.is_probable_prime() && gap_clear, oss.str() + ": следующее простое");
+}
+
+static void run_prime_tests() {
+    std::cout << "Простые числа" << std::endl;
+
+    // Решето Эратосфена до 10^6: is_probable_prime и next_prime
+    const unsigned int LIMIT = 1000000;
+    std::vector<bool> composite(LIMIT + 1, false);
+    composite[0] = composite[1] = true;
+    for (unsigned int i = 2; (unsigned long long)i * i <= LIMIT; ++i) {
+        if (composite[i]) continue;
+        for (unsigned int m = i * i; m <= LIMIT; m += i) composite[m] = true;
+    }
+    size_t mismatches = 0;
+    unsigned int first_mismatch = 0;
+    unsigned int next = LIMIT; // Наименьшее простое больше n (ниже LIMIT - по решету)
+    for (unsigned int n = LIMIT; n-- > 0;) {
+        BigInteger value((long long)n);
+        bool ok = value.is_probable_prime() == !composite[n];
+        if (n % 101 == 0 && next < LIMIT) ok = ok && value.next_prime() == BigInteger((long long)next);
+        if (!ok && mismatches++ == 0) first_mismatch = n;
+        if (!composite[n]) next = n;
+    }
+    std::ostringstream sieve;
+    sieve << "простые до " << LIMIT << " по решету: расхождений " << mismatches << ", первое - " << first_mismatch;
+    check(mismatches == 0, sieve.str());
+
+    // Сильные псевдопростые по основанию 2: до 2^64 (проверка точная) и больше - составные числа
+    // Мерсенна 2^p - 1 (p простое) и Ферма 2^(2^k) + 1
+    const unsigned long long small_pseudoprimes[] = { 2047, 3277, 4033, 4681, 8321, 15841, 29341, 42799, 49141,
+                                                      52633, 65281, 74665, 80581, 85489, 88357, 90751, 3215031751ull,
+                                                      2152302898747ull, 3474749660383ull, 341550071728321ull,
+                                                      3825123056546413051ull };
+    for (unsigned long long n : small_pseudoprimes) {
+        std::ostringstream oss;
+        oss << "сильное псевдопростое " << n;
+        check_strong_pseudoprime(BigInteger((long long)n), oss.str().c_str());
+    }
+    const int mersenne_exponents[] = { 67, 71, 101, 103, 109 };
+    for (int p : mersenne_exponents) {
+        std::ostringstream oss;
+        oss << "2^" << p << " - 1";
+        check_strong_pseudoprime((BigInteger(1) << p) - 1, oss.str().c_str());
+    }
+    check_strong_pseudoprime((BigInteger(1) << 128) + 1, "2^128 + 1");
+    check_strong_pseudoprime((BigInteger(1) << 256) + 1, "2^256 + 1");
+
+    // Числа Кармайкла (6k + 1)(12k + 1)(18k + 1) больше 2^64 (все три множителя простые)
+    const unsigned long long k_starts[] = { 1ull << 21, 1ull << 40 };
+    for (unsigned long long k_start : k_starts) {
+        int found = 0;
+        for (unsigned long long k = k_start; found < 3; ++k) {
+            BigInteger a((long long)(6 * k + 1)), b((long long)(12 * k + 1)), c((long long)(18 * k + 1));
+            if (!a.is_probable_prime() || !b.is_probable_prime() || !c.is_probable_prime()) continue;
+            ++found;
+            BigInteger n = a * b * c;
+            std::ostringstream oss;
+            oss << "число Кармайкла (6k + 1)(12k + 1)(18k + 1), k = " << k;
+            check(BigInteger::powmod(BigInteger(7), n - 1, n) == 1, oss.str() + ": псевдопростое Ферма");
+            check(!n.is_probable_prime(), oss.str() + ": отвергнуто is_probable_prime");
+        }
+    }
+
+    // next_prime с параллельной проверкой кандидатов (от PRIME_PARALLEL_BITS бит) и без нее
+    Random random(24);
+    check_next_prime(random.number(4), "next_prime ниже PRIME_PARALLEL_BITS");
+    check_next_prime(random.number(PRIME_PARALLEL_BITS / 64), "next_prime на PRIME_PARALLEL_BITS");
+    check_next_prime(random.number(PRIME_PARALLEL_BITS / 64 + 5), "next_prime выше PRIME_PARALLEL_BITS");
+}
+
+// --- Границы NTT ---
+
+// Произведение без NTT: b делится пополам, половины короче NTT_THRESHOLD и умножаются через Toom-3
+static BigInteger split_product(const BigInteger& a, const BigInteger& b) {
+    int half = (int)(b.bit_length() / 2);
+    BigInteger high = b >> half;
+    BigInteger low = b - (high << half);
+    return a * low + ((a * high) << half);
+}
+
+static void run_ntt_tests() {
+    std::cout << "Границы NTT" << std::endl;
+
+    // Длины около NTT_THRESHOLD: по одну сторону Toom-3, по другую NTT, результаты совпадают
+    Random random(4);
+    for (size_t limbs = Traits::ntt_threshold - 1; limbs <= Traits::ntt_threshold + 1; ++limbs) {
+        BigInteger ones = (BigInteger(1) << (int)(limbs * BIGINT_LIMB_BITS)) - 1;
+        BigInteger a = random.limbs(limbs), b = random.limbs(limbs);
+        std::ostringstream oss;
+        oss << "NTT_THRESHOLD, " << limbs << " блоков";
+        check(a * b == split_product(a, b), oss.str() + ": случайные множители");
+        check(ones * ones == split_product(ones, ones), oss.str() + ": все единицы");
+    }
+
+    // Преобразование наибольшей длины NTT_MAX_LENGTH с наибольшими коэффициентами свертки:
+    // (2^k - 1)^2 = 2^(2k) - 2^(k+1) + 1 (несколько секунд)
+    int k = (int)(NTT_MAX_LENGTH * 32 / 2);
+    BigInteger ones = (BigInteger(1) << k) - 1;
+    BigInteger expected = (BigInteger(1) << 2 * k) - (BigInteger(1) << (k + 1)) + 1;
+    check(ones * ones == expected, "(2^k - 1)^2 при длине преобразования NTT_MAX_LENGTH");
+}
+
+// --- Ядра над блоками ---
+
+// Сверка ядер уровня tier с шириной блока Limb со скалярным эталоном
+template <typename Limb>
+static void check_kernel_tier(CpuTier tier) {
+    typename LimbKernels<Limb>::CrossCheck result = LimbKernels<Limb>::cross_check(tier, 4000);
+    std::ostringstream oss;
+    oss << "ядра " << CpuDispatch::name(tier) << " (блок " << sizeof(Limb) * 8 << " бит): расхождений "
+        << result.mismatches;
+    if (result.mismatches) {
+        oss << ", первое - " << result.kernel << ", блоков " << result.a_size << " и " << result.b_size
+            << ", сдвиг " << result.shift;
+    }
+    check(result.mismatches == 0, oss.str());
+}
+
+// Все уровни, которые может выполнить процессор (BIGINT_CPU на сверку не влияет)
+static void run_kernel_tests() {
+    CpuTier detected = CpuDispatch::detected();
+    std::cout << "Ядра над блоками (процессор: " << CpuDispatch::name(detected) << ")" << std::endl;
+    for (int tier = CPU_TIER_SCALAR; tier <= detected; ++tier) {
+        check_kernel_tier<unsigned int>((CpuTier)tier);
+        check_kernel_tier<unsigned long long>((CpuTier)tier);
+    }
+}
+
+int main() {
+    run_kernel_tests();
+    run_root_tests();
+    run_binary_tests();
+    run_parallel_tests();
+    run_ntt_tests();
+    run_division_tests();
+    run_prime_tests();
+    run_modular_tests();
+    run_bitwise_tests();
+
+    std::cout << "Проверок: " << checks << ", ошибок: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}